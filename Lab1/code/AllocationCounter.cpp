@@ -0,0 +1,285 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the allocation counter by replacing the global operator new and delete.
+Every block starts with a small header holding its size and subsystem, so a delete is charged to the
+subsystem that allocated the block, whichever thread frees it. The array and nothrow forms are replaced as
+well, so every block the program frees went through the same operator new.
+*/
+
+#include <iomanip>
+
+#include "AllocationCounter.h"
+
+namespace
+{
+    const char* const s_Names[AllocationCounter::SubsystemCount] = { "untagged", "mushrooms", "centipedes", "lasers", "text" };
+}
+
+// @brief Get the name of a subsystem, used in the report.
+const char* AllocationCounter::getName(Subsystem subsystem)
+{
+    return s_Names[subsystem];
+}
+
+#ifdef LAB1_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<long> s_Count(0);
+
+    // Counters of a subsystem, updated by every thread
+    struct Counters
+    {
+        std::atomic<long> allocations{ 0 };
+        std::atomic<long> frees{ 0 };
+        std::atomic<long long> allocatedBytes{ 0 };
+        std::atomic<long long> freedBytes{ 0 };
+    };
+    Counters s_Counters[AllocationCounter::SubsystemCount];
+
+    thread_local int t_Subsystem = AllocationCounter::Untagged;
+
+    // Allocations per frame, only touched by the thread calling endFrame
+    long s_FirstFrame[AllocationCounter::SubsystemCount] = {};
+    long s_FrameStart[AllocationCounter::SubsystemCount] = {};
+    long s_FrameMax[AllocationCounter::SubsystemCount] = {};
+    long s_Frames = 0;
+
+    // Precedes every block, padded so the block keeps the alignment malloc gives
+    struct alignas(alignof(std::max_align_t)) Header
+    {
+        std::size_t size;
+        int subsystem;
+    };
+
+    // @brief Allocate a block with its header and charge it to the subsystem of the calling thread.
+    // @return The block, nullptr if malloc failed.
+    void* allocate(std::size_t size)
+    {
+        s_Count.fetch_add(1, std::memory_order_relaxed);
+
+        Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+        if (!header)
+        {
+            return nullptr;
+        }
+
+        header->size = size;
+        header->subsystem = t_Subsystem;
+        Counters& counters = s_Counters[header->subsystem];
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.allocatedBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+        return header + 1;
+    }
+
+    // @brief Free a block allocated by allocate and credit its subsystem.
+    void deallocate(void* p)
+    {
+        if (!p)
+        {
+            return;
+        }
+
+        Header* header = static_cast<Header*>(p) - 1;
+        Counters& counters = s_Counters[header->subsystem];
+        counters.frees.fetch_add(1, std::memory_order_relaxed);
+        counters.freedBytes.fetch_add(static_cast<long long>(header->size), std::memory_order_relaxed);
+        std::free(header);
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p);
+}
+
+// @param subsystem The subsystem of the allocations made in the scope.
+AllocationCounter::Tag::Tag(Subsystem subsystem) : m_Previous(t_Subsystem)
+{
+    t_Subsystem = subsystem;
+}
+
+// Restores the previous subsystem.
+AllocationCounter::Tag::~Tag()
+{
+    t_Subsystem = m_Previous;
+}
+
+// @brief Check whether allocations are being counted in this build.
+// @return True when built with LAB1_COUNT_ALLOCATIONS.
+bool AllocationCounter::isEnabled()
+{
+    return true;
+}
+
+// @brief Get the number of heap allocations made by the process so far.
+// @return The allocation count.
+long AllocationCounter::getCount()
+{
+    return s_Count.load(std::memory_order_relaxed);
+}
+
+// @brief Get the allocations charged to a subsystem.
+// @param subsystem The subsystem.
+// @return The counts.
+AllocationCounter::Stats AllocationCounter::getStats(Subsystem subsystem)
+{
+    const Counters& counters = s_Counters[subsystem];
+    Stats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.liveObjects = stats.allocations - counters.frees.load(std::memory_order_relaxed);
+    stats.totalBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+    stats.liveBytes = stats.totalBytes - counters.freedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// @brief Close a frame: the allocations since the previous call count towards the allocations per frame.
+void AllocationCounter::endFrame()
+{
+    for (int i = 0; i < SubsystemCount; i++)
+    {
+        long allocations = s_Counters[i].allocations.load(std::memory_order_relaxed);
+        if (s_Frames == 0)
+        {
+            s_FirstFrame[i] = allocations;
+        }
+        else if (allocations - s_FrameStart[i] > s_FrameMax[i])
+        {
+            s_FrameMax[i] = allocations - s_FrameStart[i];
+        }
+        s_FrameStart[i] = allocations;
+    }
+    s_Frames++;
+}
+
+// @brief Write the live objects, live bytes, allocated bytes and allocations per frame of every subsystem.
+// @param out The stream to write to.
+void AllocationCounter::writeReport(std::ostream& out)
+{
+    std::ios::fmtflags flags = out.flags();
+
+    // The first frame only marks where counting per frame starts
+    long frames = s_Frames > 1 ? s_Frames - 1 : 0;
+    out << "heap by subsystem over " << frames << " frames:\n";
+    out << std::left << std::setw(14) << "subsystem" << std::right << std::setw(14) << "live objects"
+        << std::setw(14) << "live bytes" << std::setw(14) << "allocations" << std::setw(16) << "bytes allocated"
+        << std::setw(12) << "per frame" << std::setw(12) << "max frame" << "\n";
+
+    out << std::fixed << std::setprecision(2);
+    for (int i = 0; i < SubsystemCount; i++)
+    {
+        Stats stats = getStats(static_cast<Subsystem>(i));
+
+        // Allocations made before the first frame, e.g. while loading, are not per frame
+        long framed = s_FrameStart[i] - s_FirstFrame[i];
+        out << std::left << std::setw(14) << s_Names[i] << std::right << std::setw(14) << stats.liveObjects
+            << std::setw(14) << stats.liveBytes << std::setw(14) << stats.allocations << std::setw(16) << stats.totalBytes
+            << std::setw(12) << (frames > 0 ? static_cast<double>(framed) / frames : 0.) << std::setw(12) << s_FrameMax[i] << "\n";
+    }
+    out.flags(flags);
+}
+
+#else
+
+// Does nothing, the counter is compiled out.
+AllocationCounter::Tag::Tag(Subsystem) : m_Previous(Untagged)
+{
+}
+
+// Does nothing, the counter is compiled out.
+AllocationCounter::Tag::~Tag()
+{
+}
+
+// @brief Check whether allocations are being counted in this build.
+// @return False, the counter is compiled out.
+bool AllocationCounter::isEnabled()
+{
+    return false;
+}
+
+// @brief Get the number of heap allocations made by the process so far.
+// @return Always 0, the counter is compiled out.
+long AllocationCounter::getCount()
+{
+    return 0;
+}
+
+// @brief Get the allocations charged to a subsystem.
+// @return All 0, the counter is compiled out.
+AllocationCounter::Stats AllocationCounter::getStats(Subsystem)
+{
+    return Stats();
+}
+
+// @brief Does nothing, the counter is compiled out.
+void AllocationCounter::endFrame()
+{
+}
+
+// @brief Say that the counter is compiled out.
+// @param out The stream to write to.
+void AllocationCounter::writeReport(std::ostream& out)
+{
+    out << "allocation tracking is compiled out, configure with LAB1_COUNT_ALLOCATIONS" << "\n";
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file declares the allocation counter. When the project is configured with
+LAB1_COUNT_ALLOCATIONS, the global operator new is replaced by one that counts every heap allocation,
+which lets the headless runner check that the steady-state frame does not allocate.
+Each allocation is also charged to the subsystem tagged on the allocating thread, so the live objects,
+live bytes and allocations per frame of the mushrooms, centipedes, lasers and text can be reported.
+Without the option the counter is compiled out and always reports zero.
+*/
+
+#pragma once
+#include <ostream>
+
+namespace AllocationCounter
+{
+    // The parts of the game allocations are charged to
+    enum Subsystem
+    {
+        Untagged,
+        Mushrooms,
+        Centipedes,
+        Lasers,
+        Text,
+        SubsystemCount
+    };
+
+    // Charges the allocations of the calling thread to a subsystem until it is destroyed
+    class Tag
+    {
+    private:
+        int m_Previous;
+
+    public:
+        // @param subsystem The subsystem of the allocations made in the scope.
+        explicit Tag(Subsystem subsystem);
+
+        // Restores the previous subsystem.
+        ~Tag();
+
+        Tag(const Tag&) = delete;
+        Tag& operator=(const Tag&) = delete;
+    };
+
+    // What a subsystem holds and has allocated so far
+    struct Stats
+    {
+        long allocations = 0;
+        long liveObjects = 0;
+        long long liveBytes = 0;
+        long long totalBytes = 0;
+    };
+
+    // @brief Check whether allocations are being counted in this build.
+    // @return True when built with LAB1_COUNT_ALLOCATIONS.
+    bool isEnabled();
+
+    // @brief Get the number of heap allocations made by the process so far.
+    // @return The allocation count, always 0 when counting is disabled.
+    long getCount();
+
+    // @brief Get the allocations charged to a subsystem.
+    // @param subsystem The subsystem.
+    // @return The counts, all 0 when counting is disabled.
+    Stats getStats(Subsystem subsystem);
+
+    // @brief Get the name of a subsystem, used in the report.
+    const char* getName(Subsystem subsystem);
+
+    // @brief Close a frame: the allocations since the previous call count towards the allocations per frame.
+    //        Call from one thread, once per frame.
+    void endFrame();
+
+    // @brief Write the live objects, live bytes, allocated bytes and allocations per frame of every subsystem.
+    // @param out The stream to write to.
+    void writeReport(std::ostream& out);
+}
@@ -0,0 +1,229 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the asset registry. Assets are kept in node based maps, so the references handed
+out stay valid when more assets are added. In headless mode images are decoded on the CPU only to learn
+their size, which is all the simulation needs. The table of the images packed in the atlas is generated
+at build time in AtlasRects.h.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+#include "AtlasRects.h"
+#include "Assets.h"
+
+namespace
+{
+    // A texture and the size of its image
+    struct TextureEntry
+    {
+        Texture texture;
+        Vector2u size;
+    };
+
+    bool s_Headless = false;
+    std::unordered_map<std::string, TextureEntry> s_Textures;
+    std::unordered_map<std::string, Font> s_Fonts;
+    Assets::Stats s_Stats;
+
+    // @brief Find an image in the table of the atlas.
+    // @param filename The image file.
+    // @return The atlas entry of the image, or nullptr if the image is not packed.
+    const Atlas::Entry* findInAtlas(const std::string& filename)
+    {
+        for (const Atlas::Entry& entry : Atlas::ENTRIES)
+        {
+            if (std::strcmp(entry.filename, filename.c_str()) == 0)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // @brief Account for a file read from disk.
+    // @param filename The file that was loaded.
+    // @param clock Started when the load began.
+    void recordLoad(const std::string& filename, const Clock& clock)
+    {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(filename, error);
+
+        s_Stats.files++;
+        s_Stats.fileBytes += error ? 0 : size;
+        s_Stats.loadTime += clock.getElapsedTime();
+    }
+
+    // @brief Find the entry of a texture file, loading it on first use.
+    // @param filename The texture file.
+    // @return The registry entry of the texture.
+    const TextureEntry& loadTexture(const std::string& filename)
+    {
+
+        auto it = s_Textures.find(filename);
+        if (it != s_Textures.end())
+        {
+            return it->second;
+        }
+
+        // Failed loads are kept as well so a missing file is only reported once
+        Clock clock;
+        TextureEntry& entry = s_Textures[filename];
+        if (s_Headless)
+        {
+            // Decode on the CPU only to get the size of the sprites
+            Image image;
+            if (image.loadFromFile(filename))
+            {
+                entry.size = image.getSize();
+            }
+        }
+        else if (entry.texture.loadFromFile(filename))
+        {
+            entry.size = entry.texture.getSize();
+        }
+
+        recordLoad(filename, clock);
+        s_Stats.textureBytes += std::size_t(entry.size.x) * entry.size.y * 4;
+        return entry;
+    }
+
+    // @brief Find the texture holding an image, loading it on first use.
+    // @param filename The image file.
+    // @return The registry entry of the atlas for a packed image, otherwise of the image itself.
+    const TextureEntry& findTexture(const std::string& filename)
+    {
+        s_Stats.requests++;
+        return loadTexture(findInAtlas(filename) ? Atlas::IMAGE : filename);
+    }
+}
+
+// @brief Switch texture loading between GPU upload and size-only headless mode.
+// @param headless True to skip all texture uploads.
+void Assets::setHeadless(bool headless)
+{
+    s_Headless = headless;
+}
+
+// @brief Check whether the game objects are being created without a graphics context.
+// @return True when running headless.
+bool Assets::isHeadless()
+{
+    return s_Headless;
+}
+
+// @brief Load every image in graphics/ and every font in fonts/ up front.
+void Assets::preload()
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+
+    for (auto& file : fs::directory_iterator("graphics", error))
+    {
+        // The packed images are only used through the atlas
+        if (file.path().extension() == ".png" && !findInAtlas(file.path().generic_string()))
+        {
+            findTexture(file.path().generic_string());
+        }
+    }
+
+    // Fonts are only drawn, the simulation never needs them
+    if (s_Headless)
+    {
+        return;
+    }
+
+    for (auto& file : fs::directory_iterator("fonts", error))
+    {
+        if (file.path().extension() == ".ttf")
+        {
+            getFont(file.path().generic_string());
+        }
+    }
+}
+
+// @brief Get the shared texture of an image, loading it on first use.
+// @param filename The image file.
+// @return A reference that stays valid for the lifetime of the process.
+const Texture& Assets::getTexture(const std::string& filename)
+{
+    return findTexture(filename).texture;
+}
+
+// @brief Get the size of an image, also available when running headless.
+// @param filename The image file.
+// @return The size of the image in pixels.
+Vector2u Assets::getTextureSize(const std::string& filename)
+{
+    IntRect rect = getTextureRect(filename);
+    return Vector2u(rect.width, rect.height);
+}
+
+// @brief Get the sub-rectangle of an image in its texture.
+// @param filename The image file.
+// @return The rectangle in the atlas for a packed image, otherwise the whole texture.
+IntRect Assets::getTextureRect(const std::string& filename)
+{
+    const Atlas::Entry* packed = findInAtlas(filename);
+    if (packed)
+    {
+        s_Stats.requests++;
+        return IntRect(packed->rect.left, packed->rect.top, packed->rect.width, packed->rect.height);
+    }
+
+    const TextureEntry& entry = findTexture(filename);
+    return IntRect(0, 0, entry.size.x, entry.size.y);
+}
+
+// @brief Attach the shared texture of an image to a sprite and make the sprite cover the whole image.
+// @param sprite The sprite to set up.
+// @param filename The image file.
+void Assets::setSprite(Sprite& sprite, const std::string& filename)
+{
+    sprite.setTexture(findTexture(filename).texture);
+    sprite.setTextureRect(getTextureRect(filename));
+}
+
+// @brief Get the shared font of a file, loading it on first use.
+// @param filename The font file.
+// @return A reference that stays valid for the lifetime of the process.
+const Font& Assets::getFont(const std::string& filename)
+{
+    s_Stats.requests++;
+
+    auto it = s_Fonts.find(filename);
+    if (it != s_Fonts.end())
+    {
+        return it->second;
+    }
+
+    Clock clock;
+    Font& font = s_Fonts[filename];
+    font.loadFromFile(filename);
+    recordLoad(filename, clock);
+    return font;
+}
+
+// @brief Get the totals of everything loaded so far.
+// @return The registry statistics.
+Assets::Stats Assets::getStats()
+{
+    return s_Stats;
+}
+
+// @brief Print the registry statistics.
+// @param out The stream to print to.
+void Assets::printStats(std::ostream& out)
+{
+    out << "assets loaded: " << s_Stats.files << " files, "
+        << s_Stats.fileBytes << " bytes on disk, "
+        << s_Stats.textureBytes << " texture bytes, "
+        << s_Stats.loadTime.asMilliseconds() << " ms, "
+        << s_Stats.requests << " requests" << std::endl;
+}
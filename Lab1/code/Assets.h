@@ -0,0 +1,92 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file declares the process-wide asset registry. Every image in graphics/ and every font in
+fonts/ is loaded from disk at most once and shared by all the game objects that use it, so creating
+mushrooms or centipede segments never touches the disk or the GPU.
+When the game runs headless (no window and no OpenGL context) textures are never uploaded;
+only the image dimensions are read so that sprite bounds, and therefore collisions, stay identical.
+The sprites of the game objects are packed at build time into a single atlas image (see AtlasPacker);
+requesting one of them returns the atlas texture and the sub-rectangle of the sprite in it.
+The registry is not synchronized: once the game starts its render thread, only the simulation thread uses it.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+using namespace sf;
+
+namespace Assets
+{
+    // Totals of everything the registry loaded
+    struct Stats
+    {
+        // Number of files read from disk
+        int files = 0;
+
+        // Size of those files on disk
+        std::size_t fileBytes = 0;
+
+        // Uncompressed size of the textures (RGBA)
+        std::size_t textureBytes = 0;
+
+        // Time spent loading
+        Time loadTime;
+
+        // Number of lookups served from the registry
+        long requests = 0;
+    };
+
+    // @brief Switch texture loading between GPU upload (default) and size-only headless mode.
+    //        Must be called before the first texture is requested.
+    // @param headless True to skip all texture uploads.
+    void setHeadless(bool headless);
+
+    // @brief Check whether the game objects are being created without a graphics context.
+    // @return True when running headless.
+    bool isHeadless();
+
+    // @brief Load every image in graphics/ and every font in fonts/ up front.
+    void preload();
+
+    // @brief Get the shared texture of an image, loading it on first use.
+    //        For an image packed in the atlas this is the atlas texture.
+    //        The texture is empty when running headless.
+    // @param filename The image file.
+    // @return A reference that stays valid for the lifetime of the process.
+    const Texture& getTexture(const std::string& filename);
+
+    // @brief Get the size of an image, also available when running headless.
+    // @param filename The image file.
+    // @return The size of the image in pixels, (0, 0) if it could not be read.
+    Vector2u getTextureSize(const std::string& filename);
+
+    // @brief Get the sub-rectangle of an image in its texture.
+    // @param filename The image file.
+    // @return The rectangle in the atlas for a packed image, otherwise the whole texture.
+    IntRect getTextureRect(const std::string& filename);
+
+    // @brief Attach the shared texture of an image to a sprite and make the sprite cover the whole image.
+    // @param sprite The sprite to set up.
+    // @param filename The image file.
+    void setSprite(Sprite& sprite, const std::string& filename);
+
+    // @brief Get the shared font of a file, loading it on first use.
+    // @param filename The font file.
+    // @return A reference that stays valid for the lifetime of the process.
+    const Font& getFont(const std::string& filename);
+
+    // @brief Get the totals of everything loaded so far.
+    // @return The registry statistics.
+    Stats getStats();
+
+    // @brief Print the registry statistics.
+    // @param out The stream to print to.
+    void printStats(std::ostream& out);
+}
@@ -0,0 +1,203 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This is the entry point of the texture atlas packer, a build tool. It packs a list of images into a single
+atlas image with a simple shelf packer (tallest images first, rows of images left to right) and writes a
+header of constexpr sub-rectangles, so the game can draw every sprite from one texture.
+
+Usage: AtlasPacker <atlas name> <output image> <output header> <images...>
+The atlas name is the path the game loads the atlas from, e.g. graphics/atlas.png; the packed images are
+registered under the same directory.
+*/
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+using namespace sf;
+
+// Transparent pixels between two images, so filtering never samples a neighbor
+const int padding = 1;
+
+// An image to pack and where it was placed
+struct PackedImage
+{
+    std::string filename;
+    Image image;
+    IntRect rect;
+};
+
+// @brief Make a C++ identifier of an image file name, e.g. CentipedeHead.png becomes CENTIPEDEHEAD.
+// @param filename The image file.
+// @return The identifier.
+std::string toIdentifier(const std::string& filename)
+{
+    std::string identifier;
+    for (char c : std::filesystem::path(filename).stem().string())
+    {
+        identifier += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    }
+    return identifier;
+}
+
+// @brief Place the images on shelves, tallest first.
+// @param images The images, their rect is set.
+// @param size Set to the size of the atlas.
+void pack(std::vector<PackedImage>& images, Vector2u& size)
+{
+    std::vector<PackedImage*> order;
+    int area = 0;
+    int widest = 0;
+    for (PackedImage& image : images)
+    {
+        order.push_back(&image);
+        area += (image.image.getSize().x + padding) * (image.image.getSize().y + padding);
+        widest = std::max(widest, static_cast<int>(image.image.getSize().x) + padding);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [](const PackedImage* a, const PackedImage* b)
+        { return a->image.getSize().y > b->image.getSize().y; });
+
+    // A power of two wide enough for a roughly square atlas
+    int width = 1;
+    while (width < widest || width * width < area)
+    {
+        width *= 2;
+    }
+
+    int x = 0;
+    int y = 0;
+    int shelfHeight = 0;
+    for (PackedImage* image : order)
+    {
+        int w = image->image.getSize().x;
+        int h = image->image.getSize().y;
+        if (x + w > width)
+        {
+            // Start a new shelf
+            x = 0;
+            y += shelfHeight + padding;
+            shelfHeight = 0;
+        }
+
+        image->rect = IntRect(x, y, w, h);
+        x += w + padding;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+
+    size = Vector2u(width, y + shelfHeight);
+}
+
+// @brief Write the header of the sub-rectangles.
+// @param filename The header file.
+// @param atlasName The path the game loads the atlas from.
+// @param images The packed images.
+// @param size The size of the atlas.
+// @return False if the file could not be written.
+bool writeHeader(const std::string& filename, const std::string& atlasName, const std::vector<PackedImage>& images, Vector2u size)
+{
+    std::ofstream out(filename);
+    std::string directory = std::filesystem::path(atlasName).parent_path().generic_string();
+
+    out << "// Generated by AtlasPacker, do not edit.\n"
+        << "#pragma once\n\n"
+        << "namespace Atlas\n"
+        << "{\n"
+        << "    // A sub-rectangle of the atlas in pixels\n"
+        << "    struct Rect\n"
+        << "    {\n"
+        << "        int left;\n"
+        << "        int top;\n"
+        << "        int width;\n"
+        << "        int height;\n"
+        << "    };\n\n"
+        << "    // An image packed in the atlas\n"
+        << "    struct Entry\n"
+        << "    {\n"
+        << "        const char* filename;\n"
+        << "        Rect rect;\n"
+        << "    };\n\n"
+        << "    constexpr const char* IMAGE = \"" << atlasName << "\";\n"
+        << "    constexpr int WIDTH = " << size.x << ";\n"
+        << "    constexpr int HEIGHT = " << size.y << ";\n\n";
+
+    for (const PackedImage& image : images)
+    {
+        out << "    constexpr Rect " << toIdentifier(image.filename) << " = { "
+            << image.rect.left << ", " << image.rect.top << ", " << image.rect.width << ", " << image.rect.height << " };\n";
+    }
+
+    out << "\n    constexpr Entry ENTRIES[] =\n"
+        << "    {\n";
+    for (const PackedImage& image : images)
+    {
+        std::string name = std::filesystem::path(image.filename).filename().string();
+        out << "        { \"" << (directory.empty() ? name : directory + "/" + name) << "\", " << toIdentifier(image.filename) << " },\n";
+    }
+    out << "    };\n"
+        << "}\n";
+
+    return static_cast<bool>(out);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: AtlasPacker <atlas name> <output image> <output header> <images...>" << std::endl;
+        return 1;
+    }
+
+    std::string atlasName = argv[1];
+    std::string outputImage = argv[2];
+    std::string outputHeader = argv[3];
+
+    std::vector<PackedImage> images(argc - 4);
+    for (int i = 4; i < argc; i++)
+    {
+        PackedImage& image = images[i - 4];
+        image.filename = argv[i];
+        if (!image.image.loadFromFile(image.filename))
+        {
+            std::cerr << "AtlasPacker: cannot load " << image.filename << std::endl;
+            return 1;
+        }
+    }
+
+    Vector2u size;
+    pack(images, size);
+
+    Image atlas;
+    atlas.create(size.x, size.y, Color::Transparent);
+    for (const PackedImage& image : images)
+    {
+        atlas.copy(image.image, image.rect.left, image.rect.top);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(outputImage).parent_path(), error);
+    std::filesystem::create_directories(std::filesystem::path(outputHeader).parent_path(), error);
+
+    if (!atlas.saveToFile(outputImage))
+    {
+        std::cerr << "AtlasPacker: cannot write " << outputImage << std::endl;
+        return 1;
+    }
+
+    if (!writeHeader(outputHeader, atlasName, images, size))
+    {
+        std::cerr << "AtlasPacker: cannot write " << outputHeader << std::endl;
+        return 1;
+    }
+
+    std::cout << "AtlasPacker: " << images.size() << " images packed into " << size.x << "x" << size.y << std::endl;
+    return 0;
+}
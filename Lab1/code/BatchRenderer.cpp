@@ -0,0 +1,115 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the BatchRenderer class. Sprites and rectangles are transformed on the CPU into
+triangles grouped by texture, so a whole frame of game objects is submitted with one draw call per texture.
+*/
+
+#include <cmath>
+
+#include "BatchRenderer.h"
+
+// @brief Get the batch of a texture, creating it the first time the texture is used.
+// @param texture The texture, or nullptr for untextured shapes.
+// @return The vertex array of the batch.
+VertexArray& BatchRenderer::getBatch(const Texture* texture)
+{
+    // Only a handful of textures exist, a linear search is the fastest lookup
+    int index = 0;
+    while (index < static_cast<int>(m_Batches.size()) && m_Batches[index].texture != texture)
+    {
+        index++;
+    }
+
+    if (index == static_cast<int>(m_Batches.size()))
+    {
+        m_Batches.push_back(Batch{ texture, VertexArray(Triangles) });
+    }
+
+    // The first object of the texture in this frame decides where the batch is drawn
+    VertexArray& vertices = m_Batches[index].vertices;
+    if (vertices.getVertexCount() == 0)
+    {
+        m_Order.push_back(index);
+    }
+    return vertices;
+}
+
+// @brief Append the two triangles of a quad to a batch.
+// @param vertices The vertex array of the batch.
+// @param transform The transform of the quad.
+// @param size The size of the quad before the transform.
+// @param color The color of the quad.
+// @param texRect The texture coordinates of the quad.
+void BatchRenderer::appendQuad(VertexArray& vertices, const Transform& transform, Vector2f size, const Color& color, const FloatRect& texRect)
+{
+    Vertex topLeft(transform.transformPoint(0, 0), color, Vector2f(texRect.left, texRect.top));
+    Vertex topRight(transform.transformPoint(size.x, 0), color, Vector2f(texRect.left + texRect.width, texRect.top));
+    Vertex bottomRight(transform.transformPoint(size.x, size.y), color, Vector2f(texRect.left + texRect.width, texRect.top + texRect.height));
+    Vertex bottomLeft(transform.transformPoint(0, size.y), color, Vector2f(texRect.left, texRect.top + texRect.height));
+
+    vertices.append(topLeft);
+    vertices.append(topRight);
+    vertices.append(bottomRight);
+
+    vertices.append(topLeft);
+    vertices.append(bottomRight);
+    vertices.append(bottomLeft);
+}
+
+// @brief Start a new frame, emptying every batch.
+void BatchRenderer::begin()
+{
+    for (Batch& batch : m_Batches)
+    {
+        batch.vertices.clear();
+    }
+    m_Order.clear();
+}
+
+// @brief Add a sprite to the batch of its texture.
+// @param sprite The sprite.
+// @param offset A translation applied to the sprite, used to interpolate moving objects.
+void BatchRenderer::add(const Sprite& sprite, Vector2f offset)
+{
+    Transform transform;
+    transform.translate(offset).combine(sprite.getTransform());
+
+    FloatRect texRect(sprite.getTextureRect());
+    appendQuad(getBatch(sprite.getTexture()), transform, Vector2f(std::abs(texRect.width), std::abs(texRect.height)),
+        sprite.getColor(), texRect);
+}
+
+// @brief Add a filled axis-aligned rectangle to the batch of untextured shapes.
+// @param rect The rectangle.
+// @param color The fill color.
+// @param offset A translation applied to the rectangle, used to interpolate moving objects.
+void BatchRenderer::add(const FloatRect& rect, const Color& color, Vector2f offset)
+{
+    Transform transform;
+    transform.translate(rect.left + offset.x, rect.top + offset.y);
+
+    appendQuad(getBatch(nullptr), transform, Vector2f(rect.width, rect.height), color, FloatRect());
+}
+
+// @brief Draw every non-empty batch, in the order their texture was first added during the frame.
+// @param target The render target.
+void BatchRenderer::draw(RenderTarget& target)
+{
+    m_DrawCalls = 0;
+    for (int index : m_Order)
+    {
+        target.draw(m_Batches[index].vertices, RenderStates(m_Batches[index].texture));
+        m_DrawCalls++;
+    }
+}
+
+// @brief Get the number of draw calls issued by the last draw().
+// @return The number of draw calls.
+int BatchRenderer::getDrawCalls() const
+{
+    return m_DrawCalls;
+}
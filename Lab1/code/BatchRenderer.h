@@ -0,0 +1,73 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the BatchRenderer class, which draws many sprites and rectangles with a few draw calls.
+Every sprite added during a frame is turned into two triangles and appended to the vertex array of its texture;
+untextured rectangles such as the lasers share one more vertex array. Drawing the frame then issues one draw call
+per texture, however many game objects there are.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+using namespace sf;
+
+class BatchRenderer
+{
+private:
+    // The triangles of all the objects using one texture, nullptr for untextured shapes
+    struct Batch
+    {
+        const Texture* texture;
+        VertexArray vertices;
+    };
+
+    // One batch per texture ever used, kept between frames to reuse their memory
+    std::vector<Batch> m_Batches;
+
+    // Indices of the batches used during the current frame, in the order their texture was first added
+    std::vector<int> m_Order;
+
+    // Draw calls issued by the last draw()
+    int m_DrawCalls = 0;
+
+    // @brief Get the batch of a texture, creating it the first time the texture is used.
+    // @param texture The texture, or nullptr for untextured shapes.
+    // @return The vertex array of the batch.
+    VertexArray& getBatch(const Texture* texture);
+
+    // @brief Append the two triangles of a quad to a batch.
+    // @param vertices The vertex array of the batch.
+    // @param transform The transform of the quad.
+    // @param size The size of the quad before the transform.
+    // @param color The color of the quad.
+    // @param texRect The texture coordinates of the quad.
+    void appendQuad(VertexArray& vertices, const Transform& transform, Vector2f size, const Color& color, const FloatRect& texRect);
+
+public:
+    // @brief Start a new frame, emptying every batch.
+    void begin();
+
+    // @brief Add a sprite to the batch of its texture.
+    // @param sprite The sprite.
+    // @param offset A translation applied to the sprite, used to interpolate moving objects.
+    void add(const Sprite& sprite, Vector2f offset = Vector2f(0, 0));
+
+    // @brief Add a filled axis-aligned rectangle to the batch of untextured shapes.
+    // @param rect The rectangle.
+    // @param color The fill color.
+    // @param offset A translation applied to the rectangle, used to interpolate moving objects.
+    void add(const FloatRect& rect, const Color& color, Vector2f offset = Vector2f(0, 0));
+
+    // @brief Draw every non-empty batch, in the order their texture was first added during the frame.
+    // @param target The render target.
+    void draw(RenderTarget& target);
+
+    // @brief Get the number of draw calls issued by the last draw().
+    // @return The number of draw calls.
+    int getDrawCalls() const;
+};
@@ -0,0 +1,236 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the box kernel. The SIMD versions are compiled for their instruction set function by
+function, so the rest of the program does not require it, and are only called once the processor was found to
+support it. A box intersects another when the larger of their left edges is before the smaller of their right
+edges, and the same on y; this is how FloatRect::intersects tells, and it rejects boxes of zero size.
+*/
+
+#include <algorithm>
+
+#include "BoxKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define LAB1_HAS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Lets a function use an instruction set the rest of the program is not compiled for
+#if defined(__GNUC__) || defined(__clang__)
+#define LAB1_TARGET(isa) __attribute__((target(isa)))
+#else
+#define LAB1_TARGET(isa)
+#endif
+
+namespace
+{
+    typedef std::uint64_t (*MaskFunction)(const FloatRect& box, const PackedBoxes& boxes, int count);
+
+    // The edges of a box, with its size made positive
+    struct Edges
+    {
+        float left;
+        float top;
+        float right;
+        float bottom;
+
+        explicit Edges(const FloatRect& box)
+        {
+            left = std::min(box.left, box.left + box.width);
+            right = std::max(box.left, box.left + box.width);
+            top = std::min(box.top, box.top + box.height);
+            bottom = std::max(box.top, box.top + box.height);
+        }
+    };
+
+    // @brief Test a box against the packed boxes [first, count) one at a time.
+    std::uint64_t scalarMask(const Edges& edges, const PackedBoxes& boxes, int first, int count)
+    {
+        std::uint64_t mask = 0;
+        for (int i = first; i < count; i++)
+        {
+            if (std::max(edges.left, boxes.left[i]) < std::min(edges.right, boxes.right[i]) &&
+                std::max(edges.top, boxes.top[i]) < std::min(edges.bottom, boxes.bottom[i]))
+            {
+                mask |= std::uint64_t(1) << i;
+            }
+        }
+        return mask;
+    }
+
+    std::uint64_t scalarOverlapMask(const FloatRect& box, const PackedBoxes& boxes, int count)
+    {
+        return scalarMask(Edges(box), boxes, 0, count);
+    }
+
+#ifdef LAB1_HAS_X86
+    LAB1_TARGET("sse2")
+    std::uint64_t sse2OverlapMask(const FloatRect& box, const PackedBoxes& boxes, int count)
+    {
+        Edges edges(box);
+        __m128 left = _mm_set1_ps(edges.left);
+        __m128 top = _mm_set1_ps(edges.top);
+        __m128 right = _mm_set1_ps(edges.right);
+        __m128 bottom = _mm_set1_ps(edges.bottom);
+
+        std::uint64_t mask = 0;
+        int i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_cmplt_ps(_mm_max_ps(left, _mm_loadu_ps(boxes.left + i)), _mm_min_ps(right, _mm_loadu_ps(boxes.right + i)));
+            __m128 y = _mm_cmplt_ps(_mm_max_ps(top, _mm_loadu_ps(boxes.top + i)), _mm_min_ps(bottom, _mm_loadu_ps(boxes.bottom + i)));
+            mask |= static_cast<std::uint64_t>(_mm_movemask_ps(_mm_and_ps(x, y))) << i;
+        }
+        return mask | scalarMask(edges, boxes, i, count);
+    }
+
+    LAB1_TARGET("avx2")
+    std::uint64_t avx2OverlapMask(const FloatRect& box, const PackedBoxes& boxes, int count)
+    {
+        Edges edges(box);
+        __m256 left = _mm256_set1_ps(edges.left);
+        __m256 top = _mm256_set1_ps(edges.top);
+        __m256 right = _mm256_set1_ps(edges.right);
+        __m256 bottom = _mm256_set1_ps(edges.bottom);
+
+        std::uint64_t mask = 0;
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_cmp_ps(_mm256_max_ps(left, _mm256_loadu_ps(boxes.left + i)),
+                _mm256_min_ps(right, _mm256_loadu_ps(boxes.right + i)), _CMP_LT_OQ);
+            __m256 y = _mm256_cmp_ps(_mm256_max_ps(top, _mm256_loadu_ps(boxes.top + i)),
+                _mm256_min_ps(bottom, _mm256_loadu_ps(boxes.bottom + i)), _CMP_LT_OQ);
+            mask |= static_cast<std::uint64_t>(_mm256_movemask_ps(_mm256_and_ps(x, y))) << i;
+        }
+
+        // The scalar code is not compiled for AVX, it would stall on the upper halves of the registers
+        _mm256_zeroupper();
+        return mask | scalarMask(edges, boxes, i, count);
+    }
+#endif
+
+    // @brief Ask the processor, and the operating system for AVX2, which instruction sets can be used.
+    BoxKernel::InstructionSet detect()
+    {
+#if defined(LAB1_HAS_X86) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+
+        // AVX2 also needs the operating system to save the 256-bit registers
+        bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        bool avx2 = osSavesAvx && (info[1] & (1 << 5)) != 0;
+#elif defined(LAB1_HAS_X86)
+        // Also checks that the operating system saves the 256-bit registers
+        __builtin_cpu_init();
+        bool sse2 = __builtin_cpu_supports("sse2");
+        bool avx2 = __builtin_cpu_supports("avx2");
+#else
+        bool sse2 = false;
+        bool avx2 = false;
+#endif
+        return avx2 ? BoxKernel::AVX2 : (sse2 ? BoxKernel::SSE2 : BoxKernel::Scalar);
+    }
+
+    // @brief Get the function of a version.
+    MaskFunction getFunction(BoxKernel::InstructionSet instructionSet)
+    {
+#ifdef LAB1_HAS_X86
+        switch (instructionSet)
+        {
+        case BoxKernel::AVX2:
+            return avx2OverlapMask;
+        case BoxKernel::SSE2:
+            return sse2OverlapMask;
+        default:
+            break;
+        }
+#endif
+        (void)instructionSet;
+        return scalarOverlapMask;
+    }
+
+    const BoxKernel::InstructionSet s_Best = detect();
+    BoxKernel::InstructionSet s_InstructionSet = s_Best;
+    MaskFunction s_Mask = getFunction(s_Best);
+
+    const char* const s_Names[] = { "scalar", "sse2", "avx2" };
+}
+
+// @brief Test a box against packed boxes.
+// @param box The box.
+// @param boxes The packed boxes.
+// @param count The number of packed boxes, at most 64.
+// @return Bit i is set when the box intersects packed box i.
+std::uint64_t BoxKernel::overlapMask(const FloatRect& box, const PackedBoxes& boxes, int count)
+{
+    return s_Mask(box, boxes, count);
+}
+
+// @brief Find the first packed box a box intersects, testing 64 boxes at a time.
+// @param box The box.
+// @param boxes The packed boxes.
+// @param count The number of packed boxes.
+// @return The index of the first intersecting box, or -1 if there is none.
+int BoxKernel::findFirst(const FloatRect& box, const PackedBoxes& boxes, int count)
+{
+    for (int first = 0; first < count; first += 64)
+    {
+        PackedBoxes chunk = { boxes.left + first, boxes.top + first, boxes.right + first, boxes.bottom + first };
+        std::uint64_t mask = s_Mask(box, chunk, std::min(count - first, 64));
+        if (mask)
+        {
+            return first + lowestBit(mask);
+        }
+    }
+    return -1;
+}
+
+// @brief Get the position of the lowest set bit of a word.
+// @param bits The word, not 0.
+// @return The index of the bit, 0 for the least significant one.
+int BoxKernel::lowestBit(std::uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// @brief Get the widest version the processor supports.
+BoxKernel::InstructionSet BoxKernel::getBest()
+{
+    return s_Best;
+}
+
+// @brief Get the version in use.
+BoxKernel::InstructionSet BoxKernel::getInstructionSet()
+{
+    return s_InstructionSet;
+}
+
+// @brief Choose the version to use, for benchmarking.
+// @param instructionSet The version, capped to the best one.
+void BoxKernel::setInstructionSet(InstructionSet instructionSet)
+{
+    s_InstructionSet = std::min(instructionSet, s_Best);
+    s_Mask = getFunction(s_InstructionSet);
+}
+
+// @brief Get the name of a version, used in reports.
+const char* BoxKernel::getName(InstructionSet instructionSet)
+{
+    return s_Names[instructionSet];
+}
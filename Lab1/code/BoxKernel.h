@@ -0,0 +1,70 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file declares the box kernel, which tests one axis-aligned box against many boxes stored as packed
+arrays of their edges, several boxes per instruction. The widest instruction set the processor supports is
+chosen when the program starts: AVX2 tests 8 boxes at a time, SSE2 4, and the scalar version one, on
+processors without either. Every version gives exactly the answer of FloatRect::intersects, so the game plays
+the same whichever one runs.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+
+using namespace sf;
+
+// Boxes stored as one array per edge, box i spans [left[i], right[i]) by [top[i], bottom[i])
+struct PackedBoxes
+{
+    const float* left;
+    const float* top;
+    const float* right;
+    const float* bottom;
+};
+
+namespace BoxKernel
+{
+    // The versions of the kernel, from the narrowest to the widest
+    enum InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // @brief Test a box against packed boxes.
+    // @param box The box, it may have a negative size like any FloatRect.
+    // @param boxes The packed boxes, their right and bottom edges are not before their left and top edges.
+    // @param count The number of packed boxes, at most 64.
+    // @return Bit i is set when the box intersects packed box i.
+    std::uint64_t overlapMask(const FloatRect& box, const PackedBoxes& boxes, int count);
+
+    // @brief Find the first packed box a box intersects.
+    // @param box The box.
+    // @param boxes The packed boxes.
+    // @param count The number of packed boxes.
+    // @return The index of the first intersecting box, or -1 if there is none.
+    int findFirst(const FloatRect& box, const PackedBoxes& boxes, int count);
+
+    // @brief Get the position of the lowest set bit of a word.
+    // @param bits The word, not 0.
+    // @return The index of the bit, 0 for the least significant one.
+    int lowestBit(std::uint64_t bits);
+
+    // @brief Get the widest version the processor supports.
+    InstructionSet getBest();
+
+    // @brief Get the version in use, the best one unless another was chosen.
+    InstructionSet getInstructionSet();
+
+    // @brief Choose the version to use, for benchmarking. Call it while no other thread uses the kernel.
+    // @param instructionSet The version, capped to the best one.
+    void setInstructionSet(InstructionSet instructionSet);
+
+    // @brief Get the name of a version, used in reports.
+    const char* getName(InstructionSet instructionSet);
+}
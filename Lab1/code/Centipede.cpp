@@ -1,172 +1,282 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This class represents a centipede entity composed of multiple CentipedeComponent segments.
-The Centipede class handles movement, collision, and interactions such as splitting when hit.
-*/
-
-#include "Centipede.h"
-
-/**
- * @brief Constructor for the Centipede class. Initializes the centipede with a given body length and starting position.
- * @param bodyLength The number of body segments (excluding the head).
- * @param startX The starting x-coordinate for the centipede's head.
- * @param startY The starting y-coordinate for the centipede's head.
- */
-Centipede::Centipede(int bodyLength, float startX, float startY)
-{
-    Vector2f p;
-    // Create the head of the centipede
-    CentipedeComponent c = CentipedeComponent(false, startX, startY);
-    std::unique_ptr<CentipedeComponent> ptr;
-
-    // Initialize head position based on the starting point and body length
-    p.x = startX - c.getPosition().width * (bodyLength + 1);
-    p.y = startY;
-    ptr = std::make_unique<CentipedeComponent>(true, p.x, p.y);
-    m_C.push_back(std::move(ptr));
-
-    // Create the rest of the centipede body segments
-    for (int i = bodyLength; i > 0; i--)
-    {
-        p.x = startX - c.getPosition().width * i;
-        p.y = startY;
-        ptr = std::make_unique<CentipedeComponent>(false, p.x, p.y);
-        m_C.push_back(std::move(ptr));
-    }
-}
-
-/**
- * @brief Constructor for the Centipede class, allowing the creation of a centipede with pre-existing components.
- * @param length The length of the centipede.
- * @param components The list of centipede components to be used for this centipede.
- */
-Centipede::Centipede(int length, std::list<std::unique_ptr<CentipedeComponent>> components)
-    : m_C(std::move(components)) {}
-
-/**
- * @brief Get the current length of the centipede.
- * @return The number of segments in the centipede.
- */
-int Centipede::getLength()
-{
-    return m_C.size();
-}
-
-/**
- * @brief Retrieve the shapes of all the centipede components.
- * @return A list of Sprite objects representing the shape of each centipede component.
- */
-std::list<Sprite> Centipede::getShape()
-{
-    std::list<Sprite> result;
-    // Iterate over each component and get its shape
-    for (auto& c : m_C)
-    {
-        result.push_back(c->getShape());
-    }
-    return result;
-}
-
-/**
- * @brief Update the centipede's position and handle potential collisions with mushrooms.
- * @param dt The time elapsed since the last update.
- * @param mushrooms A reference to a list of mushrooms to check for collisions.
- */
-void Centipede::update(Time dt, std::list<Mushroom>& mushrooms)
-{
-    auto it = std::prev(m_C.end()); // Start from the second-to-last segment
-
-    // Move each body segment to the position of the segment in front
-    while (it != m_C.begin())
-    {
-        auto prv = std::prev(it);  // Get the segment in front
-        auto sx = prv->get()->getShape().getPosition().x;
-        auto sy = prv->get()->getShape().getPosition().y;
-        auto tx = it->get()->getShape().getPosition().x;
-        auto ty = it->get()->getShape().getPosition().y;
-
-        Vector2f position;
-        // Update the current segment's position relative to the previous segment
-        position.x = tx + (sx - tx) * 18.f * dt.asSeconds();
-        position.y = ty + (sy - ty) * 18.f * dt.asSeconds();
-        it->get()->setPosition(position);
-        --it;
-    }
-
-    // Move the head segment
-    FloatRect headRect = m_C.front()->getPosition();
-    m_C.front()->movePosition(dt);
-
-    // Check for collision between the head and mushrooms
-    for (auto& mushroom : mushrooms)
-    {
-        if (headRect.intersects(mushroom.getPosition()))
-        {
-            // Handle the collision and adjust head's position
-            m_C.front()->handleCollision(mushroom.getShape().getPosition());
-            return;
-        }
-    }
-}
-
-/**
- * @brief Handles the event when the centipede is hit. If the centipede is split by the hit, returns a new centipede.
- * @param hitIndex The index of the segment that was hit.
- * @return A new centipede if the centipede is split, or nullptr if the centipede is not split or the index is invalid.
- */
-std::unique_ptr<Centipede> Centipede::handleHit(int hitIndex)
-{
-    if (hitIndex < 0 || hitIndex >= getLength())
-    {
-        return nullptr; // Invalid index
-    }
-
-    if (hitIndex == 0)
-    { // Head is hit
-        m_C.pop_front();
-        if (getLength() > 0)
-        {
-            // If there are remaining segments, designate the new head
-            m_C.front()->setHead();
-        }
-        return nullptr;
-    }
-    else if (hitIndex == getLength() - 1)
-    {
-        // Tail is hit, remove the last segment
-        m_C.pop_back();
-        return nullptr;
-    }
-
-    // If hit in the middle, split the centipede at the hit index
-    return split(hitIndex);
-}
-
-/**
- * @brief Splits the centipede into two at the specified index.
- *        The original centipede will be shortened, and a new centipede will be returned from the split segment.
- * @param index The index at which to split the centipede.
- * @return A new Centipede object starting from the hit index onward.
- */
-std::unique_ptr<Centipede> Centipede::split(int index)
-{
-    std::list<std::unique_ptr<CentipedeComponent>> newComponents;
-
-    // Move components from the current centipede to the new centipede
-    for (auto it = std::next(m_C.begin(), index + 1); it != m_C.end(); ++it)
-    {
-        newComponents.push_back(std::move(*it));
-    }
-
-    // Erase the moved components from the original centipede
-    m_C.erase(std::next(m_C.begin(), index), m_C.end());
-
-    // Set the new head for the split centipede
-    newComponents.front()->setHead();
-    // Return the new centipede
-    return std::make_unique<Centipede>(getLength() - index - 1, std::move(newComponents));
-}
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This class represents a centipede entity composed of multiple CentipedeComponent segments.
+The Centipede class handles movement, collision, and interactions such as splitting when hit.
+*/
+
+#include "Centipede.h"
+#include <algorithm>
+#include "Assets.h"
+
+/**
+ * @brief Constructor for the Centipede class. Initializes the centipede with a given body length and starting position.
+ *        The segments are appended to the arena, head first.
+ * @param arena The arena to store the segments in.
+ * @param bodyLength The number of body segments (excluding the head).
+ * @param startX The starting x-coordinate for the centipede's tail end.
+ * @param startY The starting y-coordinate for the centipede's head.
+ */
+Centipede::Centipede(SegmentArena& arena, int bodyLength, float startX, float startY)
+    : m_Arena(&arena)
+{
+    Vector2f p;
+
+    // Every segment is as wide as the body image
+    float width = Assets::getTextureSize("graphics/CentipedeBody.png").x;
+
+    // Initialize head position based on the starting point and body length
+    p.x = startX - width * (bodyLength + 1);
+    p.y = startY;
+    m_Begin = arena.append(CentipedeComponent(true, p.x, p.y));
+
+    // Create the rest of the centipede body segments
+    for (int i = bodyLength; i > 0; i--)
+    {
+        p.x = startX - width * i;
+        p.y = startY;
+        arena.append(CentipedeComponent(false, p.x, p.y));
+    }
+    m_End = arena.size();
+    updateBoundingBox();
+}
+
+/**
+ * @brief Constructor for the Centipede class, making a centipede of segments already in the arena.
+ * @param arena The arena holding the segments.
+ * @param begin The index of the head segment.
+ * @param end One past the index of the tail segment.
+ */
+Centipede::Centipede(SegmentArena& arena, int begin, int end)
+    : m_Arena(&arena), m_Begin(begin), m_End(end)
+{
+    updateBoundingBox();
+}
+
+/**
+ * @brief Recompute the bounding box of all the segments, and store the bounds of each segment in the packed
+ *        arrays of the arena for hitTest.
+ */
+void Centipede::updateBoundingBox()
+{
+    if (getLength() < 1)
+    {
+        m_BoundingBox = FloatRect();
+        return;
+    }
+
+    FloatRect first = (*m_Arena)[m_Begin].getPosition();
+    m_Arena->setBounds(m_Begin, first);
+    float left = first.left;
+    float top = first.top;
+    float right = first.left + first.width;
+    float bottom = first.top + first.height;
+
+    for (int i = m_Begin + 1; i < m_End; i++)
+    {
+        FloatRect bounds = (*m_Arena)[i].getPosition();
+        m_Arena->setBounds(i, bounds);
+        left = std::min(left, bounds.left);
+        top = std::min(top, bounds.top);
+        right = std::max(right, bounds.left + bounds.width);
+        bottom = std::max(bottom, bounds.top + bounds.height);
+    }
+
+    m_BoundingBox = FloatRect(left, top, right - left, bottom - top);
+}
+
+/**
+ * @brief Get the current length of the centipede.
+ * @return The number of segments in the centipede.
+ */
+int Centipede::getLength() const
+{
+    return m_End - m_Begin;
+}
+
+/**
+ * @brief Get the segments of the centipede for rendering, without copying them.
+ * @return A view of the segments from head to tail.
+ */
+SegmentView Centipede::getSegments() const
+{
+    const CentipedeComponent* first = m_Arena->data() + m_Begin;
+    return SegmentView(first, first + getLength());
+}
+
+/**
+ * @brief Get the collision bounds of the segments, without copying the segments.
+ * @return A view of the segment bounds from head to tail.
+ */
+BoundsView Centipede::getBounds() const
+{
+    return BoundsView(getSegments());
+}
+
+/**
+ * @brief Get the bounding box of all the segments, as of the last update or hit.
+ * @return The smallest rectangle containing every segment.
+ */
+const FloatRect& Centipede::getBoundingBox() const
+{
+    return m_BoundingBox;
+}
+
+/**
+ * @brief Find the first segment intersecting a rectangle. The bounding box is tested first,
+ *        so a centipede far from the rectangle is rejected without looking at its segments;
+ *        the segments are then tested several at a time by the box kernel.
+ * @param rect The rectangle to test.
+ * @return The index of the segment from the head, or -1 if no segment intersects the rectangle.
+ */
+int Centipede::hitTest(const FloatRect& rect) const
+{
+    if (!m_BoundingBox.intersects(rect))
+    {
+        return -1;
+    }
+
+    return BoxKernel::findFirst(rect, m_Arena->getBoxes(m_Begin), getLength());
+}
+
+/**
+ * @brief Remember the position of every segment as the start of a new simulation step.
+ */
+void Centipede::savePositions()
+{
+    for (int i = m_Begin; i < m_End; i++)
+    {
+        (*m_Arena)[i].savePosition();
+    }
+}
+
+/**
+ * @brief Update the centipede's position and handle potential collisions with mushrooms.
+ * @param dt The time elapsed since the last update.
+ * @param mushrooms A reference to the mushroom field to check for collisions.
+ */
+void Centipede::update(Time dt, const MushroomField& mushrooms)
+{
+    SegmentArena& segments = *m_Arena;
+
+    // Move each body segment to the position of the segment in front, walking from the tail to the head
+    for (int i = m_End - 1; i > m_Begin; i--)
+    {
+        const Vector2f& front = segments[i - 1].getShape().getPosition();
+        const Vector2f& current = segments[i].getShape().getPosition();
+
+        Vector2f position;
+        // Update the current segment's position relative to the previous segment
+        position.x = current.x + (front.x - current.x) * 18.f * dt.asSeconds();
+        position.y = current.y + (front.y - current.y) * 18.f * dt.asSeconds();
+        segments[i].setPosition(position);
+    }
+
+    // Move the head segment
+    CentipedeComponent& head = segments[m_Begin];
+    FloatRect headRect = head.getPosition();
+    head.movePosition(dt);
+
+    // Check for collision between the head and the mushrooms around it
+    int mushroom = mushrooms.findIntersecting(headRect);
+    if (mushroom != MushroomField::EMPTY)
+    {
+        // Handle the collision and adjust head's position
+        head.handleCollision(mushrooms.getPosition(mushroom));
+    }
+
+    updateBoundingBox();
+}
+
+/**
+ * @brief Handles the event when the centipede is hit. If the centipede is split by the hit, returns a new centipede.
+ * @param hitIndex The index of the segment that was hit.
+ * @return A new centipede if the centipede is split, or nothing if the centipede is not split or the index is invalid.
+ */
+std::optional<Centipede> Centipede::handleHit(int hitIndex)
+{
+    if (hitIndex < 0 || hitIndex >= getLength())
+    {
+        return std::nullopt; // Invalid index
+    }
+
+    if (hitIndex == 0)
+    { // Head is hit
+        m_Begin++;
+        if (getLength() > 0)
+        {
+            // If there are remaining segments, designate the new head
+            (*m_Arena)[m_Begin].setHead();
+        }
+        updateBoundingBox();
+        return std::nullopt;
+    }
+    else if (hitIndex == getLength() - 1)
+    {
+        // Tail is hit, remove the last segment
+        m_End--;
+        updateBoundingBox();
+        return std::nullopt;
+    }
+
+    // If hit in the middle, split the centipede at the hit index
+    return split(hitIndex);
+}
+
+/**
+ * @brief Splits the centipede into two at the specified index.
+ *        The original centipede will be shortened, and a new centipede will be returned from the split segment.
+ *        Only the arena ranges change, no segment is moved.
+ * @param index The index at which to split the centipede.
+ * @return A new Centipede object made of the segments behind the hit index.
+ */
+Centipede Centipede::split(int index)
+{
+    // The segments behind the hit one become the new centipede
+    int hit = m_Begin + index;
+    Centipede newCentipede(*m_Arena, hit + 1, m_End);
+
+    // The original centipede ends in front of the hit segment
+    m_End = hit;
+    updateBoundingBox();
+
+    // Set the new head for the split centipede
+    (*m_Arena)[hit + 1].setHead();
+    newCentipede.updateBoundingBox();
+    // Return the new centipede
+    return newCentipede;
+}
+
+/**
+ * @brief Save the range of the arena the centipede is made of.
+ * @param writer The state being written.
+ */
+void Centipede::saveState(StateWriter& writer) const
+{
+    writer.write(m_Begin);
+    writer.write(m_End);
+}
+
+/**
+ * @brief Make a centipede of a range written by saveState. Its bounding box is computed from the segments,
+ *        the way every update leaves it.
+ * @param arena The arena, restored first.
+ * @param reader The state being read.
+ * @return The centipede.
+ */
+Centipede Centipede::loadState(SegmentArena& arena, StateReader& reader)
+{
+    int begin = 0;
+    int end = 0;
+    reader.read(begin);
+    reader.read(end);
+    if (begin < 0 || end < begin || end > arena.size())
+    {
+        reader.fail();
+        begin = end = 0;
+    }
+    return Centipede(arena, begin, end);
+}
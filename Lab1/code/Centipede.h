@@ -1,60 +1,144 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This header file defines the Centipede class, which manages a centipede composed of multiple CentipedeComponent segments.
-The Centipede can move, handle collisions with mushrooms, split into two upon being hit, and update its position.
-*/
-
-#pragma once
-#include <SFML/Graphics.hpp>
-#include <list>
-#include <memory>
-#include "Mushroom.h"
-#include "CentipedeComponent.h"
-
-using namespace sf;
-
-class Centipede
-{
-private:
-    // A list of unique pointers to CentipedeComponent, representing the segments of the centipede.
-    std::list<std::unique_ptr<CentipedeComponent>> m_C;
-
-public:
-    // Constructor that initializes the centipede with a specified length and starting position.
-    // @param length The number of body segments of the centipede.
-    // @param startX The starting x-coordinate of the centipede's head.
-    // @param startY The starting y-coordinate of the centipede's head.
-    Centipede(int length, float startX, float startY);
-
-    // Constructor that initializes the centipede with a pre-defined list of centipede components.
-    // @param length The length of the centipede.
-    // @param components The list of centipede components to be used.
-    Centipede(int length, std::list<std::unique_ptr<CentipedeComponent>> components);
-
-    // @brief Get the current length of the centipede.
-    // @return The number of segments in the centipede.
-    int getLength();
-
-    // @brief Retrieve the sprites representing the centipede components for rendering.
-    // @return A list of Sprite objects corresponding to the centipede's segments.
-    std::list<Sprite> getShape();
-
-    // @brief Update the centipede's position and handle collisions with mushrooms.
-    // @param dt The time elapsed since the last update.
-    // @param mushrooms A reference to a list of mushrooms for collision detection.
-    void update(Time dt, std::list<Mushroom>& mushrooms);
-
-    // @brief Handle a hit on a specific centipede segment.
-    // @param hitIndex The index of the segment that was hit.
-    // @return A new centipede if the hit causes a split, or nullptr if the centipede is not split.
-    std::unique_ptr<Centipede> handleHit(int hitIndex);
-
-    // @brief Split the centipede into two at the specified index.
-    // @param index The index at which the centipede is split.
-    // @return A new Centipede object representing the split portion of the centipede.
-    std::unique_ptr<Centipede> split(int index);
-};
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the Centipede class, which manages a centipede composed of multiple CentipedeComponent segments.
+The Centipede can move, handle collisions with mushrooms, split into two upon being hit, and update its position.
+The segments live in a SegmentArena shared by all the centipedes; a Centipede is a range of that arena.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include "MushroomField.h"
+#include "CentipedeComponent.h"
+#include "SegmentArena.h"
+
+using namespace sf;
+
+// A read-only view of the segments of a centipede, from head to tail.
+// Iterating the view neither copies the segments nor allocates.
+class SegmentView
+{
+private:
+    const CentipedeComponent* m_Begin;
+    const CentipedeComponent* m_End;
+
+public:
+    SegmentView(const CentipedeComponent* begin, const CentipedeComponent* end) : m_Begin(begin), m_End(end) {}
+    const CentipedeComponent* begin() const { return m_Begin; }
+    const CentipedeComponent* end() const { return m_End; }
+    int size() const { return static_cast<int>(m_End - m_Begin); }
+};
+
+// A read-only view of the collision bounds of the segments of a centipede, from head to tail.
+// The bounds are computed when dereferenced, nothing is copied or allocated.
+class BoundsView
+{
+public:
+    class Iterator
+    {
+    private:
+        const CentipedeComponent* m_It;
+
+    public:
+        explicit Iterator(const CentipedeComponent* it) : m_It(it) {}
+        FloatRect operator*() const { return m_It->getPosition(); }
+        Iterator& operator++() { ++m_It; return *this; }
+        bool operator!=(const Iterator& other) const { return m_It != other.m_It; }
+    };
+
+private:
+    SegmentView m_Segments;
+
+public:
+    explicit BoundsView(const SegmentView& segments) : m_Segments(segments) {}
+    Iterator begin() const { return Iterator(m_Segments.begin()); }
+    Iterator end() const { return Iterator(m_Segments.end()); }
+    int size() const { return m_Segments.size(); }
+};
+
+class Centipede
+{
+private:
+    // The arena holding the segments of the centipede
+    SegmentArena* m_Arena;
+
+    // The segments of the centipede are the arena range [m_Begin, m_End), head first.
+    int m_Begin;
+    int m_End;
+
+    // Bounding box of all the segments, empty when the centipede has no segment left
+    FloatRect m_BoundingBox;
+
+    // @brief Recompute the bounding box of all the segments, and store the bounds of each segment in the arena.
+    void updateBoundingBox();
+
+public:
+    // Constructor that creates the segments of a new centipede at the end of the arena.
+    // @param arena The arena to store the segments in.
+    // @param bodyLength The number of body segments of the centipede.
+    // @param startX The starting x-coordinate of the centipede's tail end.
+    // @param startY The starting y-coordinate of the centipede's head.
+    Centipede(SegmentArena& arena, int bodyLength, float startX, float startY);
+
+    // Constructor that makes a centipede of segments already in the arena.
+    // @param arena The arena holding the segments.
+    // @param begin The index of the head segment.
+    // @param end One past the index of the tail segment.
+    Centipede(SegmentArena& arena, int begin, int end);
+
+    // @brief Get the current length of the centipede.
+    // @return The number of segments in the centipede.
+    int getLength() const;
+
+    // @brief Get the segments of the centipede for rendering, without copying them.
+    // @return A view of the segments from head to tail.
+    SegmentView getSegments() const;
+
+    // @brief Get the collision bounds of the segments, without copying the segments.
+    // @return A view of the segment bounds from head to tail.
+    BoundsView getBounds() const;
+
+    // @brief Get the bounding box of all the segments, as of the last update or hit.
+    // @return The smallest rectangle containing every segment.
+    const FloatRect& getBoundingBox() const;
+
+    // @brief Find the first segment intersecting a rectangle. The bounding box is tested first,
+    //        so a centipede far from the rectangle is rejected without looking at its segments.
+    // @param rect The rectangle to test.
+    // @return The index of the segment from the head, or -1 if no segment intersects the rectangle.
+    int hitTest(const FloatRect& rect) const;
+
+    // @brief Remember the position of every segment as the start of a new simulation step.
+    void savePositions();
+
+    // @brief Update the centipede's position and handle collisions with mushrooms.
+    //        Only the segments of this centipede are written, so centipedes can be updated in parallel.
+    // @param dt The time elapsed since the last update.
+    // @param mushrooms The mushroom field for collision detection, only read.
+    void update(Time dt, const MushroomField& mushrooms);
+
+    // @brief Handle a hit on a specific centipede segment.
+    // @param hitIndex The index of the segment that was hit.
+    // @return A new centipede if the hit causes a split, or nothing if the centipede is not split.
+    std::optional<Centipede> handleHit(int hitIndex);
+
+    // @brief Split the centipede into two at the specified index, in constant time.
+    //        The hit segment is dropped, the segments behind it become a new centipede.
+    // @param index The index at which the centipede is split.
+    // @return A new Centipede object representing the split portion of the centipede.
+    Centipede split(int index);
+
+    // @brief Save the range of the arena the centipede is made of.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Make a centipede of a range written by saveState.
+    // @param arena The arena, restored first.
+    // @param reader The state being read.
+    // @return The centipede.
+    static Centipede loadState(SegmentArena& arena, StateReader& reader);
+};
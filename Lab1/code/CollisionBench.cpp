@@ -0,0 +1,418 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This is the entry point of the collision benchmark. It shoots random laser-sized rectangles at a crowd of
+centipedes and compares testing every segment with the two-level test of Centipede::hitTest, which rejects
+a whole centipede by its bounding box before looking at its segments. Both tests must find the same hits.
+It runs a case with many short centipedes and a case with a few long ones.
+It then updates hundreds of centipedes on the calling thread and on a job system, with several numbers of
+centipedes per job, and checks that both leave every segment at the same position. It also times empty jobs;
+a job pays off once its centipedes take well longer to update than the job costs, which gives the values of
+GameWorld::setParallelCentipedes on the machine it runs on.
+It queries mushroom fields of as many mushrooms as a game, ten thousand and a million with laser-sized
+rectangles; the grid must find the same mushrooms as testing every one of them, at the same cost per query.
+Last, it times the box kernel with each instruction set the processor supports against FloatRect::intersects,
+on as many boxes as a centipede has segments and on a thousand boxes; every version must find the same hits.
+
+Usage: Lab1Bench [queries] [seed] [worker threads]
+*/
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <SFML/Graphics.hpp>
+
+#include "Assets.h"
+#include "BoxKernel.h"
+#include "Centipede.h"
+#include "GameWorld.h"
+#include "MushroomField.h"
+#include "SegmentArena.h"
+#include "JobSystem.h"
+
+using namespace sf;
+
+// Size of the rectangles shot at the centipedes, about the size of a laser
+const float queryWidth = 4.f;
+const float queryHeight = 20.f;
+
+// @brief Test a rectangle against every segment of every centipede.
+// @param centipedes The centipedes.
+// @param rect The rectangle.
+// @return The number of centipedes hit.
+int flatTest(const std::list<std::unique_ptr<Centipede>>& centipedes, const FloatRect& rect)
+{
+    int hits = 0;
+    for (auto& centipede : centipedes)
+    {
+        for (FloatRect bounds : centipede->getBounds())
+        {
+            if (bounds.intersects(rect))
+            {
+                hits++;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+// @brief Test a rectangle against the bounding box of every centipede, then against its segments.
+// @param centipedes The centipedes.
+// @param rect The rectangle.
+// @return The number of centipedes hit.
+int twoLevelTest(const std::list<std::unique_ptr<Centipede>>& centipedes, const FloatRect& rect)
+{
+    int hits = 0;
+    for (auto& centipede : centipedes)
+    {
+        if (centipede->hitTest(rect) >= 0)
+        {
+            hits++;
+        }
+    }
+    return hits;
+}
+
+// @brief Time both tests on a crowd of centipedes of the same length.
+// @param name The name of the case.
+// @param count The number of centipedes.
+// @param bodyLength The number of body segments of each centipede.
+// @param queries The number of rectangles shot.
+// @param seed The seed of the positions.
+void runCase(const std::string& name, int count, int bodyLength, long queries, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> distrX(0, defaultWindowWidth);
+    std::uniform_real_distribution<float> distrY(headerHeight, mushroomFreeHeight);
+
+    // Spread the centipedes over the playfield, then let them crawl for a while
+    SegmentArena segments;
+    std::list<std::unique_ptr<Centipede>> centipedes;
+    for (int i = 0; i < count; i++)
+    {
+        centipedes.push_back(std::make_unique<Centipede>(segments, bodyLength, distrX(engine) + defaultWindowWidth / 2, distrY(engine)));
+    }
+
+    MushroomField mushrooms(defaultWindowWidth, defaultWindowHeight);
+    for (int i = 0; i < 120; i++)
+    {
+        for (auto& centipede : centipedes)
+        {
+            centipede->update(seconds(1.f / defaultSimulationHz), mushrooms);
+        }
+    }
+
+    std::vector<FloatRect> rects;
+    for (long i = 0; i < queries; i++)
+    {
+        rects.push_back(FloatRect(distrX(engine), distrY(engine), queryWidth, queryHeight));
+    }
+
+    Clock clock;
+    long flatHits = 0;
+    for (const FloatRect& rect : rects)
+    {
+        flatHits += flatTest(centipedes, rect);
+    }
+    Time flatTime = clock.restart();
+
+    long twoLevelHits = 0;
+    for (const FloatRect& rect : rects)
+    {
+        twoLevelHits += twoLevelTest(centipedes, rect);
+    }
+    Time twoLevelTime = clock.restart();
+
+    std::cout << name << ": " << count << " centipedes of " << bodyLength + 1 << " segments\n"
+              << "  every segment: " << flatTime.asMicroseconds() * 1000.f / queries << " ns/query, " << flatHits << " hits\n"
+              << "  two-level:     " << twoLevelTime.asMicroseconds() * 1000.f / queries << " ns/query, " << twoLevelHits << " hits\n"
+              << "  speedup:       " << flatTime.asSeconds() / twoLevelTime.asSeconds() << "x" << std::endl;
+
+    if (flatHits != twoLevelHits)
+    {
+        std::cout << "  error: the tests disagree" << std::endl;
+    }
+}
+
+// @brief Create a crowd of centipedes spread over the playfield.
+// @param segments The arena of the segments.
+// @param centipedes Filled with the centipedes.
+// @param count The number of centipedes.
+// @param bodyLength The number of body segments of each centipede.
+// @param seed The seed of the positions.
+void createCrowd(SegmentArena& segments, std::list<std::unique_ptr<Centipede>>& centipedes, int count, int bodyLength, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> distrX(0, defaultWindowWidth);
+    std::uniform_real_distribution<float> distrY(headerHeight, mushroomFreeHeight);
+
+    for (int i = 0; i < count; i++)
+    {
+        centipedes.push_back(std::make_unique<Centipede>(segments, bodyLength, distrX(engine) + defaultWindowWidth / 2, distrY(engine)));
+    }
+}
+
+// @brief Time the update of many centipedes on the calling thread and on a job system.
+// @param count The number of centipedes.
+// @param bodyLength The number of body segments of each centipede.
+// @param steps The number of simulation steps.
+// @param seed The seed of the positions.
+// @param workers The number of worker threads of the job system.
+void runUpdateCase(int count, int bodyLength, int steps, unsigned seed, int workers)
+{
+    MushroomField mushrooms(defaultWindowWidth, defaultWindowHeight);
+    std::mt19937 engine(seed);
+    for (int i = 0; i < 300; i++)
+    {
+        // Placed on the lattice, as in the game
+        mushrooms.insert(std::uniform_int_distribution<int>(0, defaultWindowWidth)(engine),
+            std::uniform_int_distribution<int>(headerHeight, mushroomFreeHeight)(engine));
+    }
+
+    Time dt = seconds(1.f / defaultSimulationHz);
+
+    // Sequential update
+    SegmentArena sequentialSegments;
+    std::list<std::unique_ptr<Centipede>> sequential;
+    createCrowd(sequentialSegments, sequential, count, bodyLength, seed);
+
+    Clock clock;
+    for (int step = 0; step < steps; step++)
+    {
+        for (auto& centipede : sequential)
+        {
+            centipede->update(dt, mushrooms);
+        }
+    }
+    Time sequentialTime = clock.restart();
+
+    std::cout << "update: " << count << " centipedes of " << bodyLength + 1 << " segments, " << steps << " steps\n"
+              << "  calling thread: " << sequentialTime.asMicroseconds() / steps << " us/step, "
+              << sequentialTime.asMicroseconds() * 1000.f / (static_cast<float>(steps) * count) << " ns/centipede\n";
+
+    // What a job costs without any work, a job must hold enough centipedes to pay for it
+    JobSystem jobs(workers);
+    auto nothing = [](int, int) {};
+    clock.restart();
+    for (int step = 0; step < steps; step++)
+    {
+        jobs.parallelFor(count, 1, nothing);
+    }
+    Time overheadTime = clock.restart();
+    std::cout << "  empty jobs on " << workers << " + 1 threads: "
+              << overheadTime.asMicroseconds() * 1000.f / (static_cast<float>(steps) * count) << " ns/job" << std::endl;
+
+    // The same crowd on the job system, the way GameWorld does it, for several centipedes per job
+    for (int chunk : { 1, 4, 16, 64 })
+    {
+        SegmentArena parallelSegments;
+        std::list<std::unique_ptr<Centipede>> parallel;
+        createCrowd(parallelSegments, parallel, count, bodyLength, seed);
+
+        std::vector<Centipede*> updateList;
+        for (auto& centipede : parallel)
+        {
+            updateList.push_back(centipede.get());
+        }
+
+        auto update = [&](int begin, int end)
+        {
+            for (int i = begin; i < end; i++)
+            {
+                updateList[i]->update(dt, mushrooms);
+            }
+        };
+
+        clock.restart();
+        for (int step = 0; step < steps; step++)
+        {
+            jobs.parallelFor(static_cast<int>(updateList.size()), chunk, update);
+        }
+        Time parallelTime = clock.restart();
+
+        // Both runs must leave every segment at the same place
+        bool identical = sequentialSegments.size() == parallelSegments.size();
+        for (int i = 0; identical && i < sequentialSegments.size(); i++)
+        {
+            identical = sequentialSegments[i].getShape().getPosition() == parallelSegments[i].getShape().getPosition();
+        }
+
+        std::cout << "  " << chunk << " centipedes per job: " << parallelTime.asMicroseconds() / steps
+                  << " us/step, speedup " << sequentialTime.asSeconds() / parallelTime.asSeconds() << "x" << std::endl;
+
+        if (!identical)
+        {
+            std::cout << "  error: the updates disagree" << std::endl;
+        }
+    }
+}
+
+// @brief Time the grid queries of a mushroom field and check them against testing every mushroom.
+// @param count The number of mushrooms, filling half of the cells of a square field.
+// @param queries The number of rectangles shot at the field.
+// @param seed The seed of the mushrooms and of the rectangles.
+void runFieldCase(int count, long queries, unsigned seed)
+{
+    const int cell = MushroomField::CELL_SIZE;
+    int side = static_cast<int>(std::ceil(std::sqrt(2.0 * count)));
+    MushroomField mushrooms(side * cell, side * cell);
+
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> distrCell(0, side - 1);
+    while (mushrooms.size() < count)
+    {
+        mushrooms.insert(static_cast<float>(distrCell(engine) * cell), static_cast<float>(distrCell(engine) * cell));
+    }
+
+    std::uniform_real_distribution<float> distrPosition(0.f, static_cast<float>(side * cell));
+    std::vector<FloatRect> queryRects;
+    for (long i = 0; i < queries; i++)
+    {
+        queryRects.push_back(FloatRect(distrPosition(engine), distrPosition(engine), queryWidth, queryHeight));
+    }
+
+    Clock clock;
+    long hits = 0;
+    for (const FloatRect& query : queryRects)
+    {
+        if (mushrooms.findIntersecting(query) != MushroomField::EMPTY)
+        {
+            hits++;
+        }
+    }
+    Time gridTime = clock.restart();
+
+    // Testing every mushroom costs the size of the field per query, only a few queries are checked
+    long checked = std::min(queries, 4000000L / count + 1);
+    bool identical = true;
+    for (long i = 0; identical && i < checked; i++)
+    {
+        bool found = false;
+        for (int index = 0; !found && index < mushrooms.size(); index++)
+        {
+            found = mushrooms.getBounds(index).intersects(queryRects[i]);
+        }
+        identical = found == (mushrooms.findIntersecting(queryRects[i]) != MushroomField::EMPTY);
+    }
+
+    std::cout << "mushroom field: " << count << " mushrooms on " << side << " x " << side << " cells\n"
+              << "  grid: " << gridTime.asMicroseconds() * 1000.f / queries << " ns/query, " << hits << " hits" << std::endl;
+
+    if (!identical)
+    {
+        std::cout << "  error: the grid disagrees with testing every mushroom" << std::endl;
+    }
+}
+
+// @brief Time the box kernel against FloatRect::intersects, with every instruction set the processor supports.
+// @param count The number of packed boxes.
+// @param queries The number of rectangles tested against them.
+// @param seed The seed of the boxes.
+void runKernelCase(int count, long queries, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    std::uniform_real_distribution<float> distrX(0, defaultWindowWidth);
+    std::uniform_real_distribution<float> distrY(headerHeight, mushroomFreeHeight);
+
+    // Boxes the size of a segment, as rectangles and as packed edges
+    std::vector<FloatRect> rects;
+    std::vector<float> left, top, right, bottom;
+    for (int i = 0; i < count; i++)
+    {
+        FloatRect rect(distrX(engine), distrY(engine), 30.f, 30.f);
+        rects.push_back(rect);
+        left.push_back(rect.left);
+        top.push_back(rect.top);
+        right.push_back(rect.left + rect.width);
+        bottom.push_back(rect.top + rect.height);
+    }
+
+    // Rectangles the size of a laser, the query rectangles are far more numerous than the boxes
+    std::vector<FloatRect> queryRects;
+    for (long i = 0; i < queries / count + 1; i++)
+    {
+        queryRects.push_back(FloatRect(distrX(engine), distrY(engine), queryWidth, queryHeight));
+    }
+    long tests = static_cast<long>(queryRects.size()) * count;
+
+    Clock clock;
+    long intersectsHits = 0;
+    for (const FloatRect& query : queryRects)
+    {
+        for (const FloatRect& rect : rects)
+        {
+            if (rect.intersects(query))
+            {
+                intersectsHits++;
+            }
+        }
+    }
+    Time intersectsTime = clock.restart();
+
+    std::cout << "box kernel: " << queryRects.size() << " rectangles against " << count << " boxes\n"
+              << "  FloatRect::intersects: " << intersectsTime.asMicroseconds() * 1000.f / tests << " ns/box, "
+              << intersectsHits << " hits" << std::endl;
+
+    BoxKernel::InstructionSet best = BoxKernel::getBest();
+    for (int set = BoxKernel::Scalar; set <= best; set++)
+    {
+        BoxKernel::setInstructionSet(static_cast<BoxKernel::InstructionSet>(set));
+
+        clock.restart();
+        long hits = 0;
+        for (const FloatRect& query : queryRects)
+        {
+            for (int first = 0; first < count; first += 64)
+            {
+                PackedBoxes chunk = { left.data() + first, top.data() + first, right.data() + first, bottom.data() + first };
+                hits += std::bitset<64>(BoxKernel::overlapMask(query, chunk, std::min(count - first, 64))).count();
+            }
+        }
+        Time kernelTime = clock.restart();
+
+        std::cout << "  " << BoxKernel::getName(BoxKernel::getInstructionSet()) << " kernel: "
+                  << kernelTime.asMicroseconds() * 1000.f / tests << " ns/box, " << hits << " hits, speedup "
+                  << intersectsTime.asSeconds() / kernelTime.asSeconds() << "x" << std::endl;
+
+        if (hits != intersectsHits)
+        {
+            std::cout << "  error: the kernel disagrees with FloatRect::intersects" << std::endl;
+        }
+    }
+    BoxKernel::setInstructionSet(best);
+}
+
+int main(int argc, char* argv[])
+{
+    long queries = argc > 1 ? std::stol(argv[1]) : 200000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 1;
+    int workers = argc > 3 ? std::stoi(argv[3]) : std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+
+    // No window and no OpenGL context in this process
+    Assets::setHeadless(true);
+    Assets::preload();
+
+    runCase("many short", 64, 2, queries, seed);
+    runCase("few long", 4, 47, queries, seed);
+
+    runUpdateCase(400, 2, 1000, seed, workers);
+
+    runFieldCase(GameWorld::NUM_MUSHROOMS, queries * 10, seed);
+    runFieldCase(10000, queries * 10, seed);
+    runFieldCase(1000000, queries * 10, seed);
+
+    runKernelCase(12, queries * 10, seed);
+    runKernelCase(1024, queries * 10, seed);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the FixedTimestep class, which decouples the simulation rate from the render rate.
+*/
+
+#include <algorithm>
+
+#include "FixedTimestep.h"
+
+// Constructor that sets the simulation rate.
+// @param hz Number of simulation steps per second, checked with isValidRate.
+// @param maxFrameTime Frame times above this value are clamped to it.
+FixedTimestep::FixedTimestep(float hz, Time maxFrameTime)
+    : m_Step(stepFor(hz)), m_MaxFrameTime(maxFrameTime)
+{
+}
+
+// @brief Check a simulation rate read from the command line.
+// @param hz Number of simulation steps per second.
+// @return True if hz is in (0, MAX_HZ], false for zero, negative, infinite or NaN rates.
+bool FixedTimestep::isValidRate(float hz)
+{
+    // Written so that NaN fails both comparisons
+    return hz > 0.f && hz <= MAX_HZ;
+}
+
+// @brief Get the duration of a step at a simulation rate.
+// @param hz Number of simulation steps per second, checked with isValidRate.
+// @return The step, at least one microsecond.
+Time FixedTimestep::stepFor(float hz)
+{
+    // A zero step would make advance loop forever
+    return std::max(seconds(1.f / hz), microseconds(1));
+}
+
+// @brief Add the duration of a rendered frame to the accumulator.
+// @param frameTime The real time elapsed since the previous frame.
+// @return The number of simulation steps to run for this frame.
+int FixedTimestep::advance(Time frameTime)
+{
+    // Clamp spikes so the simulation never has to catch up for more than m_MaxFrameTime
+    if (frameTime > m_MaxFrameTime)
+    {
+        frameTime = m_MaxFrameTime;
+    }
+
+    m_Accumulator += frameTime;
+
+    int steps = 0;
+    while (m_Accumulator >= m_Step)
+    {
+        m_Accumulator -= m_Step;
+        steps++;
+    }
+    return steps;
+}
+
+// @brief Get the duration of a simulation step.
+// @return The fixed time step to pass to the simulation.
+Time FixedTimestep::getStep() const
+{
+    return m_Step;
+}
+
+// @brief Get how far the current frame is between the last two simulation steps.
+// @return A value in [0, 1) used to interpolate rendering.
+float FixedTimestep::getAlpha() const
+{
+    return m_Accumulator.asSeconds() / m_Step.asSeconds();
+}
+
+// @brief Drop the time left in the accumulator.
+void FixedTimestep::reset()
+{
+    m_Accumulator = Time::Zero;
+}
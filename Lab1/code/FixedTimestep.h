@@ -0,0 +1,65 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the FixedTimestep class, an accumulator that converts the variable time of
+rendered frames into a whole number of fixed simulation steps. Long frames (window dragged, debugger,
+loading hitch) are clamped so a single spike never produces a huge step or an endless catch-up.
+The fraction of a step left in the accumulator is used to interpolate rendering between two steps.
+A step is never shorter than one microsecond, the resolution of sf::Time, so advance always terminates.
+*/
+
+#pragma once
+#include <SFML/System.hpp>
+
+using namespace sf;
+
+class FixedTimestep
+{
+private:
+    // Duration of one simulation step
+    Time m_Step;
+
+    // Longest frame time accepted, anything above is dropped
+    Time m_MaxFrameTime;
+
+    // Time not yet simulated
+    Time m_Accumulator;
+
+public:
+    // Highest simulation rate accepted, its step is one microsecond
+    static constexpr float MAX_HZ = 1000000.f;
+
+    // Constructor that sets the simulation rate.
+    // @param hz Number of simulation steps per second, checked with isValidRate.
+    // @param maxFrameTime Frame times above this value are clamped to it.
+    explicit FixedTimestep(float hz, Time maxFrameTime = seconds(.25f));
+
+    // @brief Check a simulation rate read from the command line.
+    // @param hz Number of simulation steps per second.
+    // @return True if hz is in (0, MAX_HZ], false for zero, negative, infinite or NaN rates.
+    static bool isValidRate(float hz);
+
+    // @brief Get the duration of a step at a simulation rate.
+    // @param hz Number of simulation steps per second, checked with isValidRate.
+    // @return The step, at least one microsecond.
+    static Time stepFor(float hz);
+
+    // @brief Add the duration of a rendered frame to the accumulator.
+    // @param frameTime The real time elapsed since the previous frame.
+    // @return The number of simulation steps to run for this frame.
+    int advance(Time frameTime);
+
+    // @brief Get the duration of a simulation step.
+    // @return The fixed time step to pass to the simulation.
+    Time getStep() const;
+
+    // @brief Get how far the current frame is between the last two simulation steps.
+    // @return A value in [0, 1) used to interpolate rendering.
+    float getAlpha() const;
+
+    // @brief Drop the time left in the accumulator.
+    void reset();
+};
@@ -0,0 +1,139 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the FlightRecorder class.
+*/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "FlightRecorder.h"
+
+// Constructor that allocates the ring.
+// @param budget The longest a step may take before it is dumped.
+// @param prefix Prefix of the files written, followed by "hitch-<step>.csv".
+// @param capacity The number of steps kept.
+FlightRecorder::FlightRecorder(Time budget, const std::string& prefix, int capacity)
+    : m_Frames(std::max(capacity, 1)), m_Budget(budget.asMicroseconds() * 1000), m_Prefix(prefix)
+{
+}
+
+// @brief Start timing a step, call right before GameWorld::step.
+void FlightRecorder::beginStep()
+{
+    m_Start = std::chrono::steady_clock::now();
+}
+
+// @brief Record the step timed since beginStep, and dump the ring if it took longer than the budget.
+// @param world The world, after the step.
+// @return True if the step was a hitch and the ring was written.
+bool FlightRecorder::endStep(const GameWorld& world)
+{
+    std::int64_t total = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count();
+
+    Frame& frame = m_Frames[m_Count % m_Frames.size()];
+    frame.index = m_Count;
+    frame.total = total;
+
+    // Without a new run of the graph, the durations are those of an older step
+    const TaskGraph& graph = world.getStepGraph();
+    bool simulated = graph.getRuns() != m_GraphRuns;
+    m_GraphRuns = graph.getRuns();
+    int phases = std::min(graph.size(), MAX_PHASES);
+    for (int i = 0; i < MAX_PHASES; i++)
+    {
+        frame.phases[i] = simulated && i < phases ? graph.getDuration(i) : 0;
+    }
+
+    frame.centipedes = static_cast<int>(world.getCentipedes().size());
+    frame.segments = 0;
+    for (const auto& centipede : world.getCentipedes())
+    {
+        frame.segments += centipede.getLength();
+    }
+    frame.lasers = static_cast<int>(world.getLasers().size());
+    frame.mushrooms = world.getMushrooms().size();
+    frame.spiderActive = world.isSpiderActive();
+    frame.state = world.getState();
+
+    m_Count++;
+
+    if (total <= m_Budget)
+    {
+        return false;
+    }
+
+    m_Hitches++;
+    if (frame.index < m_NextDump)
+    {
+        // Still in the steps of the previous dump
+        return false;
+    }
+
+    std::string filename = m_Prefix + "hitch-" + std::to_string(frame.index) + ".csv";
+    if (!dump(world, filename))
+    {
+        std::cerr << "cannot write " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "step " << frame.index << " took " << total / 1000 << " us, last "
+              << std::min<std::uint64_t>(m_Count, m_Frames.size()) << " steps written to " << filename << std::endl;
+    m_NextDump = m_Count + m_Frames.size();
+    m_Dumps++;
+    return true;
+}
+
+// @brief Write the steps in the ring, oldest first.
+// @param world The world, for the names of the phases.
+// @param filename The CSV file, replaced if it exists.
+// @return False if the file could not be written.
+bool FlightRecorder::dump(const GameWorld& world, const std::string& filename) const
+{
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+
+    // Durations in microseconds
+    const TaskGraph& graph = world.getStepGraph();
+    int phases = std::min(graph.size(), MAX_PHASES);
+    out << "step,total";
+    for (int i = 0; i < phases; i++)
+    {
+        out << "," << graph.getName(i);
+    }
+    out << ",centipedes,segments,lasers,mushrooms,spider,state\n";
+
+    std::uint64_t first = m_Count > m_Frames.size() ? m_Count - m_Frames.size() : 0;
+    for (std::uint64_t index = first; index < m_Count; index++)
+    {
+        const Frame& frame = m_Frames[index % m_Frames.size()];
+        out << frame.index << "," << frame.total / 1000.;
+        for (int i = 0; i < phases; i++)
+        {
+            out << "," << frame.phases[i] / 1000.;
+        }
+        out << "," << frame.centipedes << "," << frame.segments << "," << frame.lasers << "," << frame.mushrooms
+            << "," << frame.spiderActive << "," << static_cast<int>(frame.state) << "\n";
+    }
+
+    return static_cast<bool>(out);
+}
+
+// @brief Get the number of steps that took longer than the budget.
+int FlightRecorder::getHitches() const
+{
+    return m_Hitches;
+}
+
+// @brief Get the number of files written.
+int FlightRecorder::getDumps() const
+{
+    return m_Dumps;
+}
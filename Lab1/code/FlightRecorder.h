@@ -0,0 +1,93 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the FlightRecorder class, which keeps the timings of the phases and the number of
+objects of the last few hundred steps of a GameWorld. When a step takes longer than a budget, the recorder
+writes the steps leading to it to a CSV file, so a rare hitch can be explained after the fact.
+Recording a step only writes to a ring allocated up front; only the dump allocates.
+*/
+
+#pragma once
+#include <SFML/System.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GameWorld.h"
+
+using namespace sf;
+
+class FlightRecorder
+{
+public:
+    // Phases of the step graph kept per step, the others are left out of the dumps
+    static const int MAX_PHASES = 16;
+
+    // Steps kept by default, 2.5 seconds at 120 Hz
+    static const int DEFAULT_CAPACITY = 300;
+
+    // What the recorder keeps of a step
+    struct Frame
+    {
+        std::uint64_t index;
+
+        // Durations in nanoseconds, of the whole step and of each phase of the step graph
+        std::int64_t total;
+        std::int64_t phases[MAX_PHASES];
+
+        // Objects in the world after the step
+        int centipedes;
+        int segments;
+        int lasers;
+        int mushrooms;
+        bool spiderActive;
+        GameWorld::State state;
+    };
+
+private:
+    std::vector<Frame> m_Frames;
+    std::uint64_t m_Count = 0;
+
+    std::int64_t m_Budget;
+    std::string m_Prefix;
+    std::chrono::steady_clock::time_point m_Start;
+
+    // Runs of the step graph seen so far, the phases of a paused step are left at zero
+    std::uint64_t m_GraphRuns = 0;
+
+    // A dump is only written once the ring holds no step of the previous dump
+    std::uint64_t m_NextDump = 0;
+    int m_Hitches = 0;
+    int m_Dumps = 0;
+
+    // @brief Write the steps in the ring, oldest first.
+    // @param world The world, for the names of the phases.
+    // @param filename The CSV file, replaced if it exists.
+    // @return False if the file could not be written.
+    bool dump(const GameWorld& world, const std::string& filename) const;
+
+public:
+    // Constructor that allocates the ring.
+    // @param budget The longest a step may take before it is dumped.
+    // @param prefix Prefix of the files written, followed by "hitch-<step>.csv".
+    // @param capacity The number of steps kept.
+    FlightRecorder(Time budget, const std::string& prefix, int capacity = DEFAULT_CAPACITY);
+
+    // @brief Start timing a step, call right before GameWorld::step.
+    void beginStep();
+
+    // @brief Record the step timed since beginStep, and dump the ring if it took longer than the budget.
+    // @param world The world, after the step.
+    // @return True if the step was a hitch and the ring was written.
+    bool endStep(const GameWorld& world);
+
+    // @brief Get the number of steps that took longer than the budget.
+    int getHitches() const;
+
+    // @brief Get the number of files written.
+    int getDumps() const;
+};
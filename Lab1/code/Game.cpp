@@ -1,593 +1,467 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This is the main entry point for the Centipede game. It initializes the game window, sets up the game objects
-such as centipedes, starship, mushrooms, and spider, and contains the main game loop that handles user input,
-object updates, and drawing. The game tracks the player's score, lives, and handles collisions between the
-game objects.
-*/
-
-// Include important C++ libraries here
-#include <sstream>
-#include <list>
-#include <memory>
-#include <random>
-#include <ctime>
-#include <SFML/Graphics.hpp>
-
-#include "Centipede.h"
-#include "Starship.h"
-#include "Laser.h"
-#include "Mushroom.h"
-#include "Spider.h"
-
-const int defaultWindowWidth = 1920;
-const int defaultWindowHeight = 1080;
-const int headerHeight = 75;
-const int mushroomFreeHeight = defaultWindowHeight * .8f;
-
-const int starshipStartX = defaultWindowWidth / 2;
-const int starshipStartY = defaultWindowHeight - 50;
-
-// Make code easier to type with "using namespace"
-using namespace sf;
-// Function declaration
-void generateMushrooms();
-void updateBranches(int seed);
-void handleHitCentipede(int& score);
-
-const int NUM_BRANCHES = 6;
-Sprite branches[NUM_BRANCHES];
-
-// Where is the player/branch?
-// Left or Right
-enum class side { LEFT, RIGHT, NONE };
-side branchPositions[NUM_BRANCHES];
-
-const int NUM_CENTIPEDE_BODY = 11;
-std::list<std::unique_ptr<Centipede>> centipedes;
-
-const int NUM_MUSHROOMS = 30;
-std::list<Mushroom> mushrooms;
-
-std::list<Laser> lasers;
-
-int main()
-{
-    // Create a video mode object
-    VideoMode vm(defaultWindowWidth, defaultWindowHeight);
-
-    // Create and open a window for the game
-    RenderWindow window(vm, "Centipede!!!", Style::Default);
-
-    // Create a texture to hold a graphic on the GPU
-    Texture textureBackground;
-
-    // Load a graphic into the texture
-    //textureBackground.loadFromFile("graphics/Startup-Screen-BackGround.png");
-    textureBackground.loadFromFile("graphics/background.png");
-
-    // Create a sprite
-    Sprite spriteBackground;
-
-    // Attach the texture to the sprite
-    spriteBackground.setTexture(textureBackground);
-
-    // Set the spriteBackground to cover the screen
-    spriteBackground.setPosition(0, 0);
-    //spriteBackground.setScale(sf::Vector2f(2.f, 2.f));
-
-    // Variables to control time itself
-    Clock clock;
-
-    // Track whether the game is running
-    bool paused = true;
-
-    // Game status
-    int score = 0;
-
-    sf::Text messageText;
-    sf::Text scoreText;
-
-    // We need to choose a font
-    sf::Font font;
-    font.loadFromFile("fonts/KOMIKAP_.ttf");
-
-    // Set the font to our message
-    messageText.setFont(font);
-    scoreText.setFont(font);
-
-    // Assign the actual message
-    messageText.setString("Press Enter to start!");
-    scoreText.setString("0");
-
-    // Make it really big
-    messageText.setCharacterSize(75);
-    scoreText.setCharacterSize(50);
-
-    // Choose a color
-    messageText.setFillColor(Color::White);
-    scoreText.setFillColor(Color::White);
-
-    // Position the text
-    FloatRect textRect = messageText.getLocalBounds();
-
-    messageText.setOrigin(textRect.left +
-        textRect.width / 2.0f,
-        textRect.top +
-        textRect.height / 2.0f);
-
-    messageText.setPosition(1920 / 2.0f, 1080 / 2.0f);
-
-    scoreText.setPosition(defaultWindowWidth / 2.0f, 20);
-
-    // Lifes
-    int lives = 2;
-    Texture lifeTexture;
-    lifeTexture.loadFromFile("graphics/StarShip.png");
-
-    // Create a sprite
-    Sprite lifeSprites[2];
-
-    // Attach the texture to the sprite
-    lifeSprites[0].setTexture(lifeTexture);
-    lifeSprites[0].setPosition(defaultWindowWidth / 2.0f + 300, 20);
-
-    lifeSprites[1].setTexture(lifeTexture);
-    lifeSprites[1].setPosition(defaultWindowWidth / 2.0f + 350, 20);
-
-    // Control the player input
-    bool acceptInput = false;
-
-    // Init Starship
-    Starship starship(starshipStartX, starshipStartY, 0, defaultWindowWidth, headerHeight, defaultWindowHeight);
-
-    Spider spider(0, 800);
-    bool spiderActive = true;
-
-    std::unique_ptr<Centipede> centipiede;
-    centipiede = std::make_unique<Centipede>(NUM_CENTIPEDE_BODY, defaultWindowWidth, headerHeight);
-    centipedes.push_back(std::move(centipiede));
-
-    while (window.isOpen())
-    {
-        // score ++;
-        Event event;
-        while (window.pollEvent(event))
-        {
-            if (event.type == Event::KeyReleased && !paused)
-            {
-                // Listen for key presses again
-                acceptInput = true;
-            }
-
-        }
-
-        /*
-        ****************************************
-        Handle the players input
-        ****************************************
-        */
-
-        if (Keyboard::isKeyPressed(Keyboard::Escape))
-        {
-            window.close();
-        }
-
-        // Start the game
-        if (Keyboard::isKeyPressed(Keyboard::Return))
-        {
-            paused = false;
-
-            // Reset the life and the score
-            score = 0;
-            lives = 2;
-
-            // Reset centipede position
-            centipedes.clear();
-            centipiede = std::make_unique<Centipede>(NUM_CENTIPEDE_BODY, defaultWindowWidth, headerHeight);
-            centipedes.push_back(std::move(centipiede));
-
-            // Reset Spider
-            spider.reset();
-
-            // Reset starship position
-            starship.reset();
-
-            // Make all mushrooms disappear
-            mushrooms.clear();
-
-            // Create new mushrooms
-            generateMushrooms();
-
-            acceptInput = true;
-        }
-
-        // Wrap the player controls to
-        // Make sure we are accepting input
-        if (acceptInput)
-        {
-            // First handle pressing the right cursor key
-            if (Keyboard::isKeyPressed(Keyboard::Right))
-            {
-                starship.moveRight();
-
-                acceptInput = false;
-            }
-            else
-            {
-                starship.stopRight();
-            }
-
-
-            // Handle the left cursor key
-            if (Keyboard::isKeyPressed(Keyboard::Left))
-            {
-                starship.moveLeft();
-
-                acceptInput = false;
-            }
-            else
-            {
-                starship.stopLeft();
-            }
-
-            if (Keyboard::isKeyPressed(Keyboard::Up))
-            {
-                starship.moveUp();
-            }
-            else
-            {
-                starship.stopUp();
-            }
-
-            if (Keyboard::isKeyPressed(Keyboard::Down))
-            {
-                starship.moveDown();
-            }
-            else
-            {
-                starship.stopDown();
-            }
-
-            // Handle the left cursor key
-            if (Keyboard::isKeyPressed(Keyboard::Space))
-            {
-                lasers.emplace_back(
-                    starship.getPosition().left + starship.getPosition().width / 2,
-                    starship.getPosition().top - Laser::length);
-
-                acceptInput = false;
-            }
-        }
-
-
-        /*
-        ****************************************
-        Update the scene
-        ****************************************
-        */
-        if (!paused)
-        {
-            // Measure time
-            Time dt = clock.restart();
-
-            // Update the score text
-            std::stringstream ss;
-            ss << score;
-            scoreText.setString(ss.str());
-
-            // Handle starship
-            starship.update(dt, mushrooms);
-
-            // Handle Centipede
-            for (auto& centipede : centipedes)
-            {
-                centipede->update(dt, mushrooms);
-            }
-
-            // Handle spider move
-            if (spiderActive)
-            {
-                spider.update(dt);
-            }
-            else
-            {
-                spider.reset();
-                spiderActive = true;
-            }
-
-            // Handle laser blast
-            for (auto& laser : lasers)
-            {
-                laser.update(dt);
-            }
-
-            // Check for collisions with mushrooms
-            for (auto it = mushrooms.begin(); it != mushrooms.end(); )
-            {
-                if (spider.getPosition().intersects(it->getPosition()))
-                {
-                    it = mushrooms.erase(it);
-                }
-                else
-                {
-                    ++it; // Move to the next mushroom
-                }
-            }
-
-            // Check for collisions with lasers
-            for (auto it = lasers.begin(); it != lasers.end(); )
-            {
-                if (spider.getPosition().intersects(it->getPosition()))
-                {
-                    // Collision detected, destroy the spider
-                    spiderActive = false;
-                    score += 10; // Increase the score
-                    it = lasers.erase(it); // Remove the laser if it hits the spider
-                    break;
-                }
-                else
-                {
-                    ++it; // Move to the next laser
-                }
-            }
-
-            // Handle laser and mushroom collisions
-            for (auto laserIt = lasers.begin(); laserIt != lasers.end();)
-            {
-                bool laserRemoved = false;
-
-                for (auto mushroomIt = mushrooms.begin(); mushroomIt != mushrooms.end();)
-                {
-                    if (laserIt->getPosition().intersects(mushroomIt->getPosition()))
-                    {
-                        score++;
-                        mushroomIt->reduceLife(); // Reduce life of the mushroom
-
-                        // Check if the mushroom's life is now zero
-                        if (mushroomIt->getLife() <= 0)
-                        {
-                            mushroomIt = mushrooms.erase(mushroomIt); // Remove the mushroom
-                        }
-                        else
-                        {
-                            ++mushroomIt; // Move to the next mushroom if not removed
-                        }
-
-                        laserIt = lasers.erase(laserIt); // Remove the laser
-                        laserRemoved = true;
-                        break; // Break to prevent checking other mushrooms
-                    }
-                    else
-                    {
-                        ++mushroomIt; // Move to the next mushroom if no collision
-                    }
-                }
-
-                if (!laserRemoved)
-                {
-                    ++laserIt; // Move to the next laser if not removed
-                }
-            }
-
-            // Handle laser, centipede collision
-            handleHitCentipede(score);
-
-
-            // starship collide with spider
-            if (spiderActive && spider.getPosition().intersects(starship.getPosition()))
-            {
-                starship.reset(); // Reset starship to starting location
-                lives--; // Use up a life
-            }
-
-            // Todo: starship collide with centipede
-            for (auto& centipede : centipedes)
-            {
-                auto&& cc = centipede->getShape();
-                for (auto& s : cc)
-                {
-                    if (s.getGlobalBounds().intersects(starship.getPosition()))
-                    {
-                        starship.reset();
-                        lives--;
-                    }
-                }
-            }
-
-            // Win?
-            if (centipedes.empty())
-            {
-                paused = true;
-                acceptInput = false;
-
-                // Change the text of the message
-                messageText.setString("You Win!!");
-
-                // Center it on the screen
-                FloatRect textRect = messageText.getLocalBounds();
-
-                messageText.setOrigin(textRect.left +
-                    textRect.width / 2.0f,
-                    textRect.top + textRect.height / 2.0f);
-
-                messageText.setPosition(1920 / 2.0f,
-                    1080 / 2.0f);
-            }
-
-
-            // Is game over?
-            if (lives < 0)
-            {
-                // death
-                paused = true;
-                acceptInput = false;
-
-                // Change the text of the message
-                messageText.setString("Game Over!!");
-
-                // Center it on the screen
-                FloatRect textRect = messageText.getLocalBounds();
-
-                messageText.setOrigin(textRect.left +
-                    textRect.width / 2.0f,
-                    textRect.top + textRect.height / 2.0f);
-
-                messageText.setPosition(1920 / 2.0f,
-                    1080 / 2.0f);
-            }
-
-        }// End if(!paused)
-
-         /*
-         ****************************************
-         Draw the scene
-         ****************************************
-         */
-
-         // Clear everything from the last frame
-        window.clear();
-
-        // Draw our game scene here
-        window.draw(spriteBackground);
-
-        // Draw the mushrooms
-        for (auto& mushroom : mushrooms)
-        {
-            window.draw(mushroom.getShape());
-        }
-
-        // Draw laser blasts
-        while (lasers.size()) {
-            // Has the insect reached the right hand edge of the screen?
-            if (lasers.front().getShape().getPosition().y < -100)
-            {
-                // Remove the laser
-                lasers.pop_front();
-            }
-            else
-            {
-                break;
-            }
-        }
-
-        for (auto& laser : lasers)
-        {
-            window.draw(laser.getShape());
-        }
-
-        // Draw Spider
-        if (spiderActive)
-        {
-            window.draw(spider.getShape());
-        }
-
-        // Draw Starship
-        window.draw(starship.getShape());
-
-        // Draw centipedes
-        for (auto& centipede : centipedes)
-        {
-            for (auto& i : centipede->getShape())
-            {
-                window.draw(i);
-            }
-        }
-
-        // Draw the score
-        window.draw(scoreText);
-
-        for (int i = 0; i < lives; i++)
-        {
-            window.draw(lifeSprites[i]);
-        }
-
-        if (paused)
-        {
-            // Draw our message
-            window.draw(messageText);
-        }
-
-        // Show everything we just drew
-        window.display();
-
-
-    }
-
-    return 0;
-}
-
-// Function definition
-void generateMushrooms()
-{
-    std::random_device rd;  // Obtain a random number from hardware
-    std::mt19937 eng(rd()); // Seed the generator
-    std::uniform_int_distribution<int> distrX(1, (defaultWindowWidth - 30) / 30); // Define the range
-    std::uniform_int_distribution<int> distrY((headerHeight + 60) / 30, (mushroomFreeHeight - 30) / 30);
-
-    for (int i = 0; i < NUM_MUSHROOMS; ++i)
-    {
-        int x = distrX(eng) * 30;
-        int y = distrY(eng) * 30;
-        mushrooms.emplace_back(x, y);
-    }
-}
-
-void handleHitCentipede(int& score) {
-    for (auto laserIt = lasers.begin(); laserIt != lasers.end(); ) {
-        bool laserRemoved = false;
-
-        for (auto centipedeIt = centipedes.begin(); centipedeIt != centipedes.end(); ) {
-            auto centipedeShapes = (*centipedeIt)->getShape();  // Centipede Components
-            int centipedeLength = (*centipedeIt)->getLength();  // Centipede Length
-
-            bool hit = false;
-            int hitIndex = -1;
-
-            // Check for collision with each segment
-            int index = 0;
-            for (auto& segment : centipedeShapes) {
-                if (laserIt->getPosition().intersects(segment.getGlobalBounds())) {
-                    hit = true;
-                    hitIndex = index;
-                    break;
-                }
-                index++;
-            }
-
-            if (hit) {
-                score += 10;
-                laserRemoved = true;
-
-                std::unique_ptr<Centipede> newCentipede = (*centipedeIt)->handleHit(hitIndex);
-
-                if (newCentipede) {
-                    centipedes.push_back(std::move(newCentipede)); // Add new centipede if created
-                }
-
-                // Check if the current centipede should be removed
-                if ((*centipedeIt)->getLength() < 1) {
-                    centipedeIt = centipedes.erase(centipedeIt); // Remove centipede if length is less than 1
-                }
-                else {
-                    ++centipedeIt; // Move to the next centipede
-                }
-                break;
-            }
-            else {
-                ++centipedeIt; // Move to the next centipede if no hit
-            }
-        }
-
-        if (laserRemoved) {
-            laserIt = lasers.erase(laserIt); // Remove the laser
-        }
-        else {
-            ++laserIt; // Move to the next laser
-        }
-    }
-}
\ No newline at end of file
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This is the main entry point for the Centipede game. It initializes the game window, sets up the game objects
+such as centipedes, starship, mushrooms, and spider, and contains the main game loop that handles user input,
+object updates, and drawing. The game tracks the player's score, lives, and handles collisions between the
+game objects. The simulation runs on the main thread and publishes snapshots of the world to a render thread,
+so drawing and waiting for the display never stall the simulation.
+
+Usage: Lab1 [simulation Hz] [replay to record] [hitch budget in ms]
+The replay can be played back and checked with Lab1Headless --replay. A step taking longer than the hitch
+budget, one step period by default, writes the timings of the steps before it to Lab1hitch-<step>.csv.
+An empty replay name records no replay.
+Built with LAB1_PERF_COUNTERS, the game prints the hardware counters of each phase when it exits, and built
+with LAB1_COUNT_ALLOCATIONS the heap used by the mushrooms, centipedes, lasers and texts.
+Built with LAB1_PROFILE, the game prints the time spent in each phase when it exits and writes them to
+Lab1Trace.json as a Chrome trace. The game always prints the draw calls per frame when it exits.
+*/
+
+// Include important C++ libraries here
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <SFML/Graphics.hpp>
+
+#include "AllocationCounter.h"
+#include "Assets.h"
+#include "BatchRenderer.h"
+#include "FixedTimestep.h"
+#include "FlightRecorder.h"
+#include "GameWorld.h"
+#include "PerfCounters.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "RenderSnapshot.h"
+#include "StaticLayer.h"
+#include "TripleBuffer.h"
+
+// Make code easier to type with "using namespace"
+using namespace sf;
+// Function declaration
+void updateBranches(int seed);
+
+const int NUM_BRANCHES = 6;
+Sprite branches[NUM_BRANCHES];
+
+// Where is the player/branch?
+// Left or Right
+enum class side { LEFT, RIGHT, NONE };
+side branchPositions[NUM_BRANCHES];
+
+// Draw calls issued by the render thread, reported when the game exits
+struct DrawStats
+{
+    long frames = 0;
+    long drawCalls = 0;
+    int maxDrawCalls = 0;
+};
+
+// What the render thread draws besides the snapshots, taken from the asset registry before the thread starts
+struct RenderAssets
+{
+    Sprite background;
+    Sprite life;
+    const Font* font = nullptr;
+};
+
+// @brief Center the message text on the screen after its string changed.
+// @param messageText The text to center.
+void centerMessage(Text& messageText)
+{
+    FloatRect textRect = messageText.getLocalBounds();
+
+    messageText.setOrigin(textRect.left +
+        textRect.width / 2.0f,
+        textRect.top +
+        textRect.height / 2.0f);
+
+    messageText.setPosition(1920 / 2.0f, 1080 / 2.0f);
+}
+
+// @brief Update the score and the message when the snapshot changed them.
+// @param snapshot The snapshot being drawn.
+// @param lastScore The score shown, updated.
+// @param lastState The state the message shows, updated.
+// @param scoreText The score text.
+// @param messageText The message text.
+void updateTexts(const RenderSnapshot& snapshot, int& lastScore, GameWorld::State& lastState, Text& scoreText,
+    Text& messageText)
+{
+    // The texts allocate their strings when they change
+    AllocationCounter::Tag tag(AllocationCounter::Text);
+
+    if (snapshot.state == GameWorld::State::Playing && snapshot.score != lastScore)
+    {
+        // Update the score text
+        lastScore = snapshot.score;
+        std::stringstream ss;
+        ss << lastScore;
+        scoreText.setString(ss.str());
+    }
+
+    if (snapshot.state != lastState)
+    {
+        lastState = snapshot.state;
+
+        // Change the text of the message
+        if (lastState == GameWorld::State::Won)
+        {
+            messageText.setString("You Win!!");
+            centerMessage(messageText);
+        }
+        else if (lastState == GameWorld::State::Lost)
+        {
+            messageText.setString("Game Over!!");
+            centerMessage(messageText);
+        }
+    }
+}
+
+// @brief Draw the snapshots published by the simulation until the game is closed. Runs on its own thread,
+//        so waiting for the display never delays the simulation.
+// @param window The window, activated on this thread.
+// @param snapshots The snapshots published by the simulation thread.
+// @param running Cleared by the simulation thread to stop rendering.
+// @param clock The clock timing the snapshots, used to interpolate between steps.
+// @param step The duration of a simulation step.
+// @param stats The draw calls of the frames, read once the thread is joined.
+// @param assets The background, life sprite and font, the asset registry is not used on this thread.
+void renderLoop(RenderWindow& window, TripleBuffer<RenderSnapshot>& snapshots, const std::atomic<bool>& running,
+    const Clock& clock, Time step, DrawStats& stats, const RenderAssets& assets)
+{
+    window.setActive(true);
+    Profiler::setThreadName("render");
+
+    // The background and the mushrooms are composited off-screen and only redrawn where a mushroom changed
+    StaticLayer staticLayer(assets.background, defaultWindowWidth, defaultWindowHeight);
+
+    sf::Text messageText;
+    sf::Text scoreText;
+
+    // Set the font to our message
+    messageText.setFont(*assets.font);
+    scoreText.setFont(*assets.font);
+
+    // Assign the actual message
+    messageText.setString("Press Enter to start!");
+    scoreText.setString("0");
+
+    // Make it really big
+    messageText.setCharacterSize(75);
+    scoreText.setCharacterSize(50);
+
+    // Choose a color
+    messageText.setFillColor(Color::White);
+    scoreText.setFillColor(Color::White);
+
+    // Position the text
+    centerMessage(messageText);
+
+    scoreText.setPosition(defaultWindowWidth / 2.0f, 20);
+
+    // Lifes, create a sprite
+    Sprite lifeSprites[GameWorld::START_LIVES] = { assets.life, assets.life };
+
+    lifeSprites[0].setPosition(defaultWindowWidth / 2.0f + 300, 20);
+    lifeSprites[1].setPosition(defaultWindowWidth / 2.0f + 350, 20);
+
+    GameWorld::State lastState = GameWorld::State::Title;
+    int lastScore = 0;
+
+    // The game objects are drawn with one draw call per texture
+    BatchRenderer renderer;
+
+    while (running)
+    {
+        PROFILE_SCOPE("frame");
+
+        // Take the newest snapshot, the first one is published before this thread starts
+        if (snapshots.acquire())
+        {
+            staticLayer.update(snapshots.getFront());
+        }
+        const RenderSnapshot& snapshot = snapshots.getFront();
+
+        // How far this frame is between the last two steps
+        float alpha = std::min((clock.getElapsedTime() - snapshot.stepEnd) / step, 1.f);
+
+        updateTexts(snapshot, lastScore, lastState, scoreText, messageText);
+
+         /*
+         ****************************************
+         Draw the scene
+         ****************************************
+         */
+
+         // Clear everything from the last frame
+        window.clear();
+
+        // Draw our game scene here, starting with the background and the mushrooms
+        renderer.begin();
+        renderer.add(staticLayer.getSprite());
+
+        // Draw laser blasts, moving objects are drawn between their previous and current positions
+        for (const RenderSnapshot::RectInstance& laser : snapshot.lasers)
+        {
+            renderer.add(laser.bounds, laser.color, RenderSnapshot::interpolate(laser.previousOffset, alpha));
+        }
+
+        // Draw the spider, the starship and the centipedes
+        for (const RenderSnapshot::SpriteInstance& instance : snapshot.sprites)
+        {
+            renderer.add(instance.sprite, RenderSnapshot::interpolate(instance.previousOffset, alpha));
+        }
+
+        for (int i = 0; i < snapshot.lives; i++)
+        {
+            renderer.add(lifeSprites[i]);
+        }
+
+        {
+            PROFILE_SCOPE("draw");
+            renderer.draw(window);
+        }
+
+        // The number of draw calls only depends on the textures in use, not on the number of objects
+        stats.frames++;
+        stats.drawCalls += renderer.getDrawCalls();
+        stats.maxDrawCalls = std::max(stats.maxDrawCalls, renderer.getDrawCalls());
+
+        {
+            // Drawing a text that changed rebuilds its geometry
+            AllocationCounter::Tag tag(AllocationCounter::Text);
+
+            // Draw the score
+            window.draw(scoreText);
+
+            if (snapshot.state != GameWorld::State::Playing)
+            {
+                // Draw our message
+                window.draw(messageText);
+            }
+        }
+
+        // Show everything we just drew
+        PROFILE_SCOPE("display");
+        window.display();
+    }
+
+    window.setActive(false);
+}
+
+// @brief Read the events and the keyboard into the controls of the next steps.
+// @param window The window receiving the events.
+// @param input The controls, a key release is kept until a step has seen it.
+// @param running Cleared when the player presses Escape.
+void pollInput(RenderWindow& window, InputState& input, std::atomic<bool>& running)
+{
+    PROFILE_SCOPE("input");
+
+    Event event;
+    while (window.pollEvent(event))
+    {
+        if (event.type == Event::KeyReleased)
+        {
+            // Listen for key presses again
+            input.keyReleased = true;
+        }
+
+    }
+
+    /*
+    ****************************************
+    Handle the players input
+    ****************************************
+    */
+
+    if (Keyboard::isKeyPressed(Keyboard::Escape))
+    {
+        running = false;
+    }
+
+    input.start = Keyboard::isKeyPressed(Keyboard::Return);
+    input.right = Keyboard::isKeyPressed(Keyboard::Right);
+    input.left = Keyboard::isKeyPressed(Keyboard::Left);
+    input.up = Keyboard::isKeyPressed(Keyboard::Up);
+    input.down = Keyboard::isKeyPressed(Keyboard::Down);
+    input.fire = Keyboard::isKeyPressed(Keyboard::Space);
+}
+
+// Usage: Lab1 [simulation Hz] [replay to record] [hitch budget in ms]
+int main(int argc, char* argv[])
+{
+    // Create a video mode object
+    VideoMode vm(defaultWindowWidth, defaultWindowHeight);
+
+    // Create and open a window for the game
+    RenderWindow window(vm, "Centipede!!!", Style::Default);
+
+    // Load every graphic and font once, the game objects share them
+    Assets::preload();
+    Assets::printStats(std::cout);
+
+    // The registry is not thread-safe, resolve what the render thread draws before the simulation uses it
+    RenderAssets renderAssets;
+
+    // Attach the texture to the sprite
+    //renderAssets.background.setTexture(Assets::getTexture("graphics/Startup-Screen-BackGround.png"));
+    renderAssets.background.setTexture(Assets::getTexture("graphics/background.png"));
+
+    // Set the background to cover the screen
+    renderAssets.background.setPosition(0, 0);
+
+    // Attach the starship image of the atlas to the sprite of a life
+    Assets::setSprite(renderAssets.life, "graphics/StarShip.png");
+
+    // We need to choose a font
+    renderAssets.font = &Assets::getFont("fonts/KOMIKAP_.ttf");
+
+    Profiler::setThreadName("simulation");
+
+    // Variables to control time itself
+    Clock clock;
+
+    // Never restarted, shared with the render thread to time the snapshots
+    Clock gameClock;
+
+    // The simulation runs at a fixed rate, independently of the frame rate
+    float hz = argc > 1 ? std::stof(argv[1]) : defaultSimulationHz;
+    if (!FixedTimestep::isValidRate(hz))
+    {
+        std::cerr << "simulation rate must be above 0 and at most " << static_cast<long>(FixedTimestep::MAX_HZ) << " Hz" << std::endl;
+        return 1;
+    }
+    FixedTimestep timestep(hz);
+
+    // Threads running the simulation steps with this thread, besides the render thread. They sleep while the
+    // steps are too cheap to split, which they are unless the parallel centipede update is enabled
+    JobSystem jobs(std::max(static_cast<int>(std::thread::hardware_concurrency()) - 2, 0));
+
+    // All the game objects, score and lives
+    GameWorld world(std::random_device{}());
+    world.setJobSystem(&jobs);
+    std::cout << "seed: " << world.getSeed() << std::endl;
+
+    // Record the seed and the input of every step, to replay the session
+    ReplayRecorder recorder;
+    if (argc > 2 && *argv[2] && !recorder.open(argv[2], world, timestep.getStep()))
+    {
+        std::cerr << "cannot write replay " << argv[2] << std::endl;
+    }
+
+    // Keep the timings of the last steps, written out when a step is too slow
+    FlightRecorder flightRecorder(argc > 3 ? seconds(std::stof(argv[3]) / 1000) : timestep.getStep(), "Lab1");
+
+    // Hardware counters of every phase, reported when the game exits
+    PerfReport perfReport;
+
+    InputState input;
+
+    // The simulation runs on this thread and hands snapshots of the world to the render thread
+    TripleBuffer<RenderSnapshot> snapshots;
+    snapshots.getBack().capture(world, gameClock.getElapsedTime(), false);
+    snapshots.publish();
+
+    std::atomic<bool> running(true);
+    DrawStats drawStats;
+    window.setActive(false);
+    std::thread renderThread(renderLoop, std::ref(window), std::ref(snapshots), std::cref(running),
+        std::cref(gameClock), timestep.getStep(), std::ref(drawStats), std::cref(renderAssets));
+
+    // Set when the snapshot in the back slot was never drawn
+    bool keepChanges = false;
+
+    while (running)
+    {
+        pollInput(window, input, running);
+
+        /*
+        ****************************************
+        Update the scene
+        ****************************************
+        */
+
+        // Measure time, also while paused so the first frame of a game does not get the whole pause
+        int steps = timestep.advance(clock.restart());
+
+        for (int i = 0; i < steps; i++)
+        {
+            PROFILE_SCOPE("step");
+            flightRecorder.beginStep();
+            world.step(timestep.getStep(), input);
+            flightRecorder.endStep(world);
+            if (PerfCounters::isEnabled())
+            {
+                perfReport.add(world.getStepGraph());
+            }
+            if (recorder.isOpen())
+            {
+                recorder.record(input, world);
+            }
+
+            // Key releases are events, they are kept until one step has seen them
+            input.keyReleased = false;
+        }
+
+        if (steps > 0)
+        {
+            AllocationCounter::endFrame();
+
+            // Hand the new state to the render thread
+            PROFILE_SCOPE("capture");
+            snapshots.getBack().capture(world, gameClock.getElapsedTime(), keepChanges);
+            keepChanges = snapshots.publish();
+        }
+        else
+        {
+            // Wait for the next step
+            sf::sleep(timestep.getStep() * (1.f - timestep.getAlpha()));
+        }
+    }
+
+    renderThread.join();
+    window.close();
+
+    if (drawStats.frames > 0)
+    {
+        std::cout << "draw calls per frame: " << drawStats.drawCalls / static_cast<float>(drawStats.frames)
+                  << " average, " << drawStats.maxDrawCalls << " max over " << drawStats.frames << " frames"
+                  << std::endl;
+    }
+
+    if (recorder.isOpen() && recorder.close(world))
+    {
+        std::cout << "replay of " << recorder.getSteps() << " steps written to " << argv[2] << std::endl;
+    }
+
+    if (PerfCounters::isEnabled())
+    {
+        perfReport.writeReport(std::cout);
+    }
+
+    if (AllocationCounter::isEnabled())
+    {
+        AllocationCounter::writeReport(std::cout);
+    }
+
+    // Every thread is stopped or idle, the profile is complete
+    if (Profiler::isEnabled())
+    {
+        Profiler::writeReport(std::cout);
+        if (Profiler::writeChromeTrace("Lab1Trace.json"))
+        {
+            std::cout << "trace written to Lab1Trace.json" << std::endl;
+        }
+    }
+
+    return 0;
+}
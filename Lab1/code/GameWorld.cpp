@@ -0,0 +1,890 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the GameWorld class. It contains the game rules that used to live in the main loop:
+player input, object updates, collisions between the game objects, score, lives and the win/lose checks.
+A step is a graph of phases, so the phases that do not depend on each other can run at the same time.
+*/
+
+#include <algorithm>
+
+#include "AllocationCounter.h"
+#include "GameWorld.h"
+
+/**
+ * @brief Constructor for the GameWorld class. Creates the starship, the spider and the first centipede.
+ * @param seed The seed of every random stream of the world.
+ */
+GameWorld::GameWorld(unsigned seed)
+    : m_Segments(m_LevelMemory.getResource()),
+      m_Centipedes(m_LevelMemory.getResource()),
+      m_Mushrooms(defaultWindowWidth, defaultWindowHeight, m_LevelMemory.getResource()),
+      m_Starship(starshipStartX, starshipStartY, 0, defaultWindowWidth, headerHeight, defaultWindowHeight),
+      m_Spider(0, 800),
+      m_Seed(seed),
+      m_Engine(getStreamSeed(seed, MushroomStream))
+{
+    m_Spider.seed(getStreamSeed(seed, SpiderStream));
+
+    // The overlaps the game rules care about
+    m_Broadphase.enablePair(SweepAndPrune::Laser, SweepAndPrune::Centipede);
+    m_Broadphase.enablePair(SweepAndPrune::Laser, SweepAndPrune::Spider);
+    m_Broadphase.enablePair(SweepAndPrune::Centipede, SweepAndPrune::Starship);
+    m_Broadphase.enablePair(SweepAndPrune::Spider, SweepAndPrune::Starship);
+
+    // A laser is known to the broadphase by its slot, so firing one never grows the broadphase
+    m_Broadphase.reserve(SweepAndPrune::Laser, m_Lasers.getCapacity());
+
+    {
+        AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+        m_Centipedes.emplace_back(m_Segments, NUM_CENTIPEDE_BODY, defaultWindowWidth, headerHeight);
+    }
+
+    buildStepGraph();
+}
+
+/**
+ * @brief Start a new game: reset the score, lives and all game objects.
+ */
+void GameWorld::reset()
+{
+    m_State = State::Playing;
+
+    // Reset the life and the score
+    m_Score = 0;
+    m_Lives = START_LIVES;
+
+    // Reset centipede position, the centipedes and mushrooms of the previous game are released at once
+    releaseLevel();
+    m_Broadphase.clear();
+    {
+        AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+        m_Centipedes.emplace_back(m_Segments, NUM_CENTIPEDE_BODY, defaultWindowWidth, headerHeight);
+    }
+
+    // Reset Spider
+    m_Spider.reset();
+
+    // Reset starship position
+    m_Starship.reset();
+
+    // Create new mushrooms
+    generateMushrooms();
+
+    m_AcceptInput = true;
+}
+
+/**
+ * @brief Remove the centipedes, their segments and the mushrooms, and release their memory at once.
+ *        The containers give their storage back first, so nothing refers to the released memory.
+ */
+void GameWorld::releaseLevel()
+{
+    m_Centipedes.clear();
+    m_Segments.clear();
+    m_Mushrooms.clear();
+    m_LevelMemory.release();
+}
+
+/**
+ * @brief Apply the player controls to the starship and fire lasers.
+ * @param input The controls for this step.
+ */
+void GameWorld::handleInput(const InputState& input)
+{
+    if (input.keyReleased && !isPaused())
+    {
+        // Listen for key presses again
+        m_AcceptInput = true;
+    }
+
+    // Start the game
+    if (input.start)
+    {
+        reset();
+    }
+
+    // Make sure we are accepting input
+    if (!m_AcceptInput)
+    {
+        return;
+    }
+
+    // First handle pressing the right cursor key
+    if (input.right)
+    {
+        m_Starship.moveRight();
+        m_AcceptInput = false;
+    }
+    else
+    {
+        m_Starship.stopRight();
+    }
+
+    // Handle the left cursor key
+    if (input.left)
+    {
+        m_Starship.moveLeft();
+        m_AcceptInput = false;
+    }
+    else
+    {
+        m_Starship.stopLeft();
+    }
+
+    if (input.up)
+    {
+        m_Starship.moveUp();
+    }
+    else
+    {
+        m_Starship.stopUp();
+    }
+
+    if (input.down)
+    {
+        m_Starship.moveDown();
+    }
+    else
+    {
+        m_Starship.stopDown();
+    }
+
+    // Fire a laser from the nose of the starship
+    if (input.fire)
+    {
+        Laser& laser = m_Lasers.push(
+            m_Starship.getPosition().left + m_Starship.getPosition().width / 2,
+            m_Starship.getPosition().top - Laser::length);
+        laser.resolveTarget(m_Mushrooms);
+
+        m_AcceptInput = false;
+    }
+}
+
+/**
+ * @brief Run the phases of the steps on a job system, once setParallelCentipedes() made them expensive enough.
+ * @param jobs The job system, it must outlive the world; nullptr to run on the calling thread.
+ */
+void GameWorld::setJobSystem(JobSystem* jobs)
+{
+    m_Jobs = jobs;
+}
+
+/**
+ * @brief Check whether the step is expensive enough to run on the job system.
+ * @return True if a job system is attached and there are enough centipedes to update them in parallel.
+ */
+bool GameWorld::isParallelStep() const
+{
+    return m_Jobs && m_ParallelCentipedes > 0 && static_cast<int>(m_Centipedes.size()) >= m_ParallelCentipedes;
+}
+
+/**
+ * @brief Update the centipedes in parallel on the job system once there are enough of them.
+ * @param minimum The fewest centipedes updated in parallel, 0 to always update them on one thread.
+ * @param chunk The number of centipedes of a job.
+ */
+void GameWorld::setParallelCentipedes(int minimum, int chunk)
+{
+    m_ParallelCentipedes = minimum;
+    m_CentipedeChunk = std::max(chunk, 1);
+}
+
+/**
+ * @brief Declare the phases of a step and what each of them must wait for.
+ *        The objects move independently of each other, and the mushrooms are only read while they move.
+ *        The collision passes share the score and the lasers, each laser hitting at most one thing,
+ *        so they keep the order of the original main loop.
+ */
+void GameWorld::buildStepGraph()
+{
+    TaskGraph& graph = m_StepGraph;
+    TaskGraph::TaskId save = graph.addTask("save positions", &runPhase<&GameWorld::savePositions>, this);
+    TaskGraph::TaskId starship = graph.addTask("update starship", &runPhase<&GameWorld::updateStarship>, this);
+    TaskGraph::TaskId centipedes = graph.addTask("update centipedes", &runPhase<&GameWorld::updateCentipedes>, this);
+    TaskGraph::TaskId spider = graph.addTask("update spider", &runPhase<&GameWorld::updateSpider>, this);
+    TaskGraph::TaskId lasers = graph.addTask("update lasers", &runPhase<&GameWorld::updateLasers>, this);
+    TaskGraph::TaskId spiderMushrooms = graph.addTask("spider eats mushrooms", &runPhase<&GameWorld::eraseSpiderMushrooms>, this);
+    TaskGraph::TaskId broadphase = graph.addTask("broadphase", &runPhase<&GameWorld::updateBroadphase>, this);
+    TaskGraph::TaskId hitSpider = graph.addTask("lasers hit spider", &runPhase<&GameWorld::handleHitSpider>, this);
+    TaskGraph::TaskId hitMushrooms = graph.addTask("lasers hit mushrooms", &runPhase<&GameWorld::handleHitMushrooms>, this);
+    TaskGraph::TaskId hitCentipedes = graph.addTask("lasers hit centipedes", &runPhase<&GameWorld::handleHitCentipede>, this);
+    TaskGraph::TaskId eraseLasers = graph.addTask("erase lasers", &runPhase<&GameWorld::eraseHitLasers>, this);
+    TaskGraph::TaskId hitStarship = graph.addTask("starship hit", &runPhase<&GameWorld::handleHitStarship>, this);
+    TaskGraph::TaskId eraseCentipedes = graph.addTask("erase centipedes", &runPhase<&GameWorld::eraseShotCentipedes>, this);
+    TaskGraph::TaskId outcome = graph.addTask("win or lose", &runPhase<&GameWorld::checkOutcome>, this);
+
+    // Every object moves once its previous position is saved
+    graph.precede(save, starship);
+    graph.precede(save, centipedes);
+    graph.precede(save, spider);
+    graph.precede(save, lasers);
+
+    // The spider changes the mushrooms the starship and the centipedes collide with
+    graph.precede({ starship, centipedes, spider }, spiderMushrooms);
+
+    // The broadphase needs every object at its new position
+    graph.precede({ starship, centipedes, spider, lasers }, broadphase);
+
+    // A laser hits the spider, else a mushroom, else a centipede
+    graph.precede(broadphase, hitSpider);
+    graph.precede({ hitSpider, spiderMushrooms }, hitMushrooms);
+    graph.precede(hitMushrooms, hitCentipedes);
+
+    // Erasing the spent lasers and hurting the starship touch different objects
+    graph.precede(hitCentipedes, eraseLasers);
+    graph.precede(hitCentipedes, hitStarship);
+
+    // The centipedes shot entirely stay in the list until nothing reads their proxies anymore
+    graph.precede({ eraseLasers, hitStarship }, eraseCentipedes);
+    graph.precede(eraseCentipedes, outcome);
+}
+
+/**
+ * @brief Advance the game by one step.
+ * @param dt The time elapsed since the last step.
+ * @param input The player controls for this step.
+ */
+void GameWorld::step(Time dt, const InputState& input)
+{
+    handleInput(input);
+
+    if (!isPaused())
+    {
+        m_StepTime = dt;
+
+        // The phases besides the centipede update take well under a microsecond each, less than a job
+        // costs, so the step only runs on the job system when the centipedes are updated in parallel
+        if (isParallelStep())
+        {
+            m_StepGraph.run(*m_Jobs);
+        }
+        else
+        {
+            m_StepGraph.run();
+        }
+    }
+
+    // Remove the lasers that left the screen
+    while (m_Lasers.size())
+    {
+        if (m_Lasers.front().getShape().getPosition().y < -100)
+        {
+            m_Lasers.popFront();
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Move the starship, which stops at the mushrooms.
+ */
+void GameWorld::updateStarship()
+{
+    m_Starship.update(m_StepTime, m_Mushrooms);
+}
+
+/**
+ * @brief Move the spider, or bring it back once it was shot.
+ */
+void GameWorld::updateSpider()
+{
+    if (m_SpiderActive)
+    {
+        m_Spider.update(m_StepTime);
+    }
+    else
+    {
+        m_Spider.reset();
+        m_SpiderActive = true;
+    }
+}
+
+/**
+ * @brief Move the lasers.
+ */
+void GameWorld::updateLasers()
+{
+    for (auto& laser : m_Lasers)
+    {
+        laser.update(m_StepTime);
+    }
+}
+
+/**
+ * @brief Let the spider eat the mushrooms it walks over.
+ */
+void GameWorld::eraseSpiderMushrooms()
+{
+    m_Mushrooms.eraseIntersecting(m_Spider.getPosition());
+}
+
+/**
+ * @brief Destroy the spider if a laser hits it. The laser is removed from the broadphase,
+ *        it is erased from the list once all the collisions are resolved.
+ */
+void GameWorld::handleHitSpider()
+{
+    for (const SweepAndPrune::Pair& pair : m_Broadphase.getPairs())
+    {
+        const SweepAndPrune::Proxy& laser = m_Broadphase.getProxy(pair.first);
+        if (laser.kind == SweepAndPrune::Laser && m_Broadphase.getProxy(pair.second).kind == SweepAndPrune::Spider)
+        {
+            // Collision detected, destroy the spider
+            m_SpiderActive = false;
+            m_Score += 10; // Increase the score
+            m_Broadphase.remove(SweepAndPrune::Laser, laser.key); // Remove the laser if it hits the spider
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Damage the first mushroom in the way of each laser.
+ */
+void GameWorld::handleHitMushrooms()
+{
+    for (auto& laser : m_Lasers)
+    {
+        int slot = m_Lasers.getSlot(laser);
+        if (m_Broadphase.isRemoved(SweepAndPrune::Laser, slot))
+        {
+            continue;
+        }
+
+        // The laser knows the first mushroom in its way
+        int mushroom = laser.findMushroomHit(m_Mushrooms);
+        if (mushroom != MushroomField::EMPTY)
+        {
+            m_Score++;
+            m_Mushrooms.reduceLife(mushroom); // Reduce life of the mushroom
+
+            // Check if the mushroom's life is now zero
+            if (m_Mushrooms.getLife(mushroom) <= 0)
+            {
+                m_Mushrooms.erase(mushroom); // Remove the mushroom
+            }
+
+            m_Broadphase.remove(SweepAndPrune::Laser, slot); // Remove the laser
+        }
+    }
+}
+
+/**
+ * @brief Erase the lasers that hit something during the step.
+ */
+void GameWorld::eraseHitLasers()
+{
+    m_Lasers.eraseIf([this](const Laser& laser)
+    {
+        return m_Broadphase.isRemoved(SweepAndPrune::Laser, m_Lasers.getSlot(laser));
+    });
+}
+
+/**
+ * @brief Take a life when the spider or a centipede runs into the starship.
+ */
+void GameWorld::handleHitStarship()
+{
+    for (const SweepAndPrune::Pair& pair : m_Broadphase.getPairs())
+    {
+        const SweepAndPrune::Proxy& first = m_Broadphase.getProxy(pair.first);
+        if (m_Broadphase.getProxy(pair.second).kind != SweepAndPrune::Starship)
+        {
+            continue;
+        }
+
+        if (first.kind == SweepAndPrune::Spider && m_SpiderActive)
+        {
+            // starship collide with spider
+            m_Starship.reset(); // Reset starship to starting location
+            m_Lives--; // Use up a life
+        }
+        else if (first.kind == SweepAndPrune::Centipede)
+        {
+            // starship collide with centipede
+            const Centipede* centipede = static_cast<const Centipede*>(first.owner);
+            if (first.alive && centipede->hitTest(m_Starship.getPosition()) >= 0)
+            {
+                m_Starship.reset();
+                m_Lives--;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check whether the game is won or lost.
+ */
+void GameWorld::checkOutcome()
+{
+    // Win?
+    if (m_Centipedes.empty())
+    {
+        m_State = State::Won;
+        m_AcceptInput = false;
+    }
+
+    // Is game over?
+    if (m_Lives < 0)
+    {
+        m_State = State::Lost;
+        m_AcceptInput = false;
+    }
+}
+
+/**
+ * @brief Remember the position of every moving object as the start of a new step.
+ */
+void GameWorld::savePositions()
+{
+    m_Starship.savePosition();
+    m_Spider.savePosition();
+
+    for (auto& centipede : m_Centipedes)
+    {
+        centipede.savePositions();
+    }
+
+    for (auto& laser : m_Lasers)
+    {
+        laser.savePosition();
+    }
+}
+
+/**
+ * @brief Place NUM_MUSHROOMS mushrooms on distinct random cells of the playfield.
+ */
+void GameWorld::generateMushrooms()
+{
+    const int cell = MushroomField::CELL_SIZE;
+    std::uniform_int_distribution<int> distrX(1, (defaultWindowWidth - cell) / cell); // Define the range
+    std::uniform_int_distribution<int> distrY((headerHeight + 2 * cell) / cell, (mushroomFreeHeight - cell) / cell);
+
+    // A cell holds a single mushroom, draw again when it is already taken
+    while (m_Mushrooms.size() < NUM_MUSHROOMS)
+    {
+        int x = distrX(m_Engine) * cell;
+        int y = distrY(m_Engine) * cell;
+        m_Mushrooms.insert(x, y);
+    }
+}
+
+/**
+ * @brief Move every centipede, in parallel when enabled and there are enough of them.
+ *        Centipedes only read the mushroom field and write their own segments,
+ *        so the result does not depend on the number of threads.
+ */
+void GameWorld::updateCentipedes()
+{
+    AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+    Time dt = m_StepTime;
+    if (!isParallelStep())
+    {
+        for (auto& centipede : m_Centipedes)
+        {
+            centipede.update(dt, m_Mushrooms);
+        }
+        return;
+    }
+
+    m_UpdateList.clear();
+    for (auto& centipede : m_Centipedes)
+    {
+        m_UpdateList.push_back(&centipede);
+    }
+
+    const MushroomField& mushrooms = m_Mushrooms;
+    auto update = [this, dt, &mushrooms](int begin, int end)
+    {
+        for (int i = begin; i < end; i++)
+        {
+            m_UpdateList[i]->update(dt, mushrooms);
+        }
+    };
+    m_Jobs->parallelFor(static_cast<int>(m_UpdateList.size()), m_CentipedeChunk, update);
+}
+
+/**
+ * @brief Give the current bounds of every moving object to the broadphase and find the overlapping pairs.
+ */
+void GameWorld::updateBroadphase()
+{
+    m_Broadphase.beginStep();
+
+    // Lasers are known by their slot in the ring, centipedes by their place in the list
+    for (Laser& laser : m_Lasers)
+    {
+        m_Broadphase.update(SweepAndPrune::Laser, m_Lasers.getSlot(laser), &laser, laser.getPosition());
+    }
+
+    int key = 0;
+    for (auto& centipede : m_Centipedes)
+    {
+        m_Broadphase.update(SweepAndPrune::Centipede, key++, &centipede, centipede.getBoundingBox());
+    }
+
+    if (m_SpiderActive)
+    {
+        m_Broadphase.update(SweepAndPrune::Spider, 0, &m_Spider, m_Spider.getPosition());
+    }
+
+    m_Broadphase.update(SweepAndPrune::Starship, 0, &m_Starship, m_Starship.getPosition());
+
+    m_Broadphase.endStep();
+}
+
+/**
+ * @brief Shoot a centipede if a laser hits one of its segments.
+ * @param centipede The centipede.
+ * @param laser The slot of the laser, removed from the broadphase on a hit.
+ * @param bounds The bounds of the laser.
+ */
+void GameWorld::hitCentipede(Centipede& centipede, int laser, const FloatRect& bounds)
+{
+    int hitIndex = centipede.hitTest(bounds);
+    if (hitIndex < 0)
+    {
+        return;
+    }
+
+    m_Score += 10;
+    m_Broadphase.remove(SweepAndPrune::Laser, laser); // Remove the laser
+
+    std::optional<Centipede> newCentipede = centipede.handleHit(hitIndex);
+
+    if (newCentipede) {
+        m_Centipedes.push_back(*newCentipede); // Add new centipede if created
+    }
+}
+
+/**
+ * @brief Resolve the collisions between lasers and centipedes, splitting the centipedes that are hit.
+ *        The broadphase reports the lasers overlapping the bounding box of a centipede, only those
+ *        are tested against the segments.
+ */
+void GameWorld::handleHitCentipede()
+{
+    AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+    size_t centipedeCount = m_Centipedes.size();
+
+    for (const SweepAndPrune::Pair& pair : m_Broadphase.getPairs())
+    {
+        const SweepAndPrune::Proxy& laser = m_Broadphase.getProxy(pair.first);
+        const SweepAndPrune::Proxy& centipede = m_Broadphase.getProxy(pair.second);
+        if (laser.kind == SweepAndPrune::Laser && centipede.kind == SweepAndPrune::Centipede && laser.alive && centipede.alive)
+        {
+            // Centipedes are only erased at the end of the step, the owner is still valid
+            Centipede* target = static_cast<Centipede*>(centipede.owner);
+            hitCentipede(*target, laser.key, laser.bounds);
+        }
+    }
+
+    // The centipedes split off during this step are not in the broadphase yet,
+    // test them against the lasers that did not hit anything
+    for (auto it = std::next(m_Centipedes.begin(), centipedeCount); it != m_Centipedes.end(); ++it)
+    {
+        for (const Laser& laser : m_Lasers)
+        {
+            int slot = m_Lasers.getSlot(laser);
+            if (!m_Broadphase.isRemoved(SweepAndPrune::Laser, slot))
+            {
+                hitCentipede(*it, slot, laser.getPosition());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Erase the centipedes that were shot entirely. They are kept until the starship was tested
+ *        against them, so the owners of the broadphase proxies stay valid through the step.
+ */
+void GameWorld::eraseShotCentipedes()
+{
+    // The centipedes split off during the step come after the ones in the broadphase, their keys are not in use
+    int key = 0;
+    for (const Centipede& centipede : m_Centipedes)
+    {
+        if (centipede.getLength() < 1)
+        {
+            m_Broadphase.remove(SweepAndPrune::Centipede, key);
+        }
+        key++;
+    }
+
+    m_Centipedes.remove_if([](const Centipede& centipede) { return centipede.getLength() < 1; });
+}
+
+/**
+ * @brief Derive the seed of a random stream from the seed of a world.
+ *        Neighboring seeds and streams give unrelated engines.
+ * @param seed The seed of the world.
+ * @param stream The stream.
+ * @return The seed of the engine of the stream.
+ */
+unsigned GameWorld::getStreamSeed(unsigned seed, RandomStream stream)
+{
+    std::seed_seq sequence{ seed, static_cast<unsigned>(stream) };
+    unsigned streamSeed;
+    sequence.generate(&streamSeed, &streamSeed + 1);
+    return streamSeed;
+}
+
+/**
+ * @brief Get the seed the world was created with.
+ * @return The seed of the world.
+ */
+unsigned GameWorld::getSeed() const
+{
+    return m_Seed;
+}
+
+// FNV-1a over the bytes of a value
+static void hashBytes(std::uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+static void hashPosition(std::uint64_t& hash, Vector2f position)
+{
+    hashBytes(hash, &position.x, sizeof(position.x));
+    hashBytes(hash, &position.y, sizeof(position.y));
+}
+
+/**
+ * @brief Compute a hash of the complete state of the game, used to check that a replay plays the same game.
+ *        The positions are hashed bit by bit, so the slightest divergence changes the hash.
+ * @return A 64-bit FNV-1a hash of the positions, lives of the mushrooms, score, lives and state.
+ */
+std::uint64_t GameWorld::getChecksum() const
+{
+    std::uint64_t hash = 14695981039346656037ull;
+
+    int state = static_cast<int>(m_State);
+    hashBytes(hash, &state, sizeof(state));
+    hashBytes(hash, &m_Score, sizeof(m_Score));
+    hashBytes(hash, &m_Lives, sizeof(m_Lives));
+    hashBytes(hash, &m_SpiderActive, sizeof(m_SpiderActive));
+
+    hashPosition(hash, m_Starship.getShape().getPosition());
+    hashPosition(hash, m_Spider.getShape().getPosition());
+
+    for (auto& centipede : m_Centipedes)
+    {
+        for (const CentipedeComponent& segment : centipede.getSegments())
+        {
+            hashPosition(hash, segment.getShape().getPosition());
+        }
+    }
+
+    for (const Laser& laser : m_Lasers)
+    {
+        hashPosition(hash, laser.getShape().getPosition());
+    }
+
+    for (int i = 0; i < m_Mushrooms.size(); i++)
+    {
+        int life = m_Mushrooms.getLife(i);
+        hashPosition(hash, m_Mushrooms.getPosition(i));
+        hashBytes(hash, &life, sizeof(life));
+    }
+
+    return hash;
+}
+
+// Layout of the state written by saveState, changed whenever a saved field is added or removed
+static const unsigned stateVersion = 1;
+
+/**
+ * @brief Save the complete state of the game. The arena is saved whole, so the ranges of the centipedes
+ *        stay valid; the lasers and the mushrooms keep their order.
+ * @param buffer The state is appended to it.
+ */
+void GameWorld::saveState(std::vector<char>& buffer) const
+{
+    StateWriter writer(buffer);
+    writer.write(stateVersion);
+    writer.write(m_Seed);
+    writer.write(m_State);
+    writer.write(m_Score);
+    writer.write(m_Lives);
+    writer.write(m_AcceptInput);
+    writer.write(m_SpiderActive);
+    writer.writeEngine(m_Engine);
+
+    m_Starship.saveState(writer);
+    m_Spider.saveState(writer);
+
+    m_Segments.saveState(writer);
+    writer.write(static_cast<int>(m_Centipedes.size()));
+    for (auto& centipede : m_Centipedes)
+    {
+        centipede.saveState(writer);
+    }
+
+    m_Mushrooms.saveState(writer);
+
+    writer.write(static_cast<int>(m_Lasers.size()));
+    for (const Laser& laser : m_Lasers)
+    {
+        laser.saveState(writer);
+    }
+}
+
+/**
+ * @brief Restore a state written by saveState. The broadphase starts over; its order only depends on
+ *        where the objects are, so it finds the same pairs in the same order.
+ * @param data The first byte of the state.
+ * @param size The number of bytes of the state.
+ * @return False if the state is malformed.
+ */
+bool GameWorld::loadState(const char* data, size_t size)
+{
+    StateReader reader(data, size);
+
+    unsigned version = 0;
+    reader.read(version);
+    if (version != stateVersion)
+    {
+        return false;
+    }
+
+    reader.read(m_Seed);
+    reader.read(m_State);
+    reader.read(m_Score);
+    reader.read(m_Lives);
+    reader.read(m_AcceptInput);
+    reader.read(m_SpiderActive);
+    reader.readEngine(m_Engine);
+
+    m_Starship.loadState(reader);
+    m_Spider.loadState(reader);
+
+    // The mushrooms are read after the centipedes, release the memory of both first
+    releaseLevel();
+    m_Segments.loadState(reader);
+    int centipedes = 0;
+    reader.read(centipedes);
+    for (int i = 0; i < centipedes && reader.isValid(); i++)
+    {
+        AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+        m_Centipedes.push_back(Centipede::loadState(m_Segments, reader));
+    }
+
+    m_Mushrooms.loadState(reader);
+
+    m_Lasers.clear();
+    int lasers = 0;
+    reader.read(lasers);
+    for (int i = 0; i < lasers && reader.isValid(); i++)
+    {
+        m_Lasers.push(0.f, 0.f).loadState(reader);
+    }
+
+    m_Broadphase.clear();
+    return reader.isValid() && reader.atEnd();
+}
+
+/**
+ * @brief Check whether the simulation is paused.
+ * @return True on the title, win and game over screens.
+ */
+bool GameWorld::isPaused() const
+{
+    return m_State != State::Playing;
+}
+
+/**
+ * @brief Get where the game currently is.
+ * @return The current state of the game.
+ */
+GameWorld::State GameWorld::getState() const
+{
+    return m_State;
+}
+
+/**
+ * @brief Get the current score.
+ * @return The score of the player.
+ */
+int GameWorld::getScore() const
+{
+    return m_Score;
+}
+
+/**
+ * @brief Get the remaining lives.
+ * @return The number of spare starships.
+ */
+int GameWorld::getLives() const
+{
+    return m_Lives;
+}
+
+/**
+ * @brief Check whether the spider is alive.
+ * @return True if the spider should be drawn.
+ */
+bool GameWorld::isSpiderActive() const
+{
+    return m_SpiderActive;
+}
+
+std::pmr::list<Centipede>& GameWorld::getCentipedes()
+{
+    return m_Centipedes;
+}
+
+MushroomField& GameWorld::getMushrooms()
+{
+    return m_Mushrooms;
+}
+
+LaserRing& GameWorld::getLasers()
+{
+    return m_Lasers;
+}
+
+Starship& GameWorld::getStarship()
+{
+    return m_Starship;
+}
+
+Spider& GameWorld::getSpider()
+{
+    return m_Spider;
+}
+
+const std::pmr::list<Centipede>& GameWorld::getCentipedes() const
+{
+    return m_Centipedes;
+}
+
+const MushroomField& GameWorld::getMushrooms() const
+{
+    return m_Mushrooms;
+}
+
+const LaserRing& GameWorld::getLasers() const
+{
+    return m_Lasers;
+}
+
+/**
+ * @brief Get the graph of the phases of a step, with how long each phase took in the last step.
+ */
+const TaskGraph& GameWorld::getStepGraph() const
+{
+    return m_StepGraph;
+}
@@ -0,0 +1,293 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the GameWorld class, which owns the complete state of a Centipede game
+(centipedes, mushrooms, lasers, spider, starship, score and lives) and advances it one step at a time.
+GameWorld does not depend on a window or on the keyboard, so it can be driven by the interactive game
+as well as by the headless runner. Everything random in a game is drawn from engines seeded by the seed of
+the world, so the same seed and the same inputs always play the same game.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <random>
+
+#include "Centipede.h"
+#include "Starship.h"
+#include "Laser.h"
+#include "LaserRing.h"
+#include "LevelMemory.h"
+#include "MushroomField.h"
+#include "Spider.h"
+#include "SweepAndPrune.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
+
+using namespace sf;
+
+const int defaultWindowWidth = 1920;
+const int defaultWindowHeight = 1080;
+const int headerHeight = 75;
+const int mushroomFreeHeight = defaultWindowHeight * .8f;
+
+const int starshipStartX = defaultWindowWidth / 2;
+const int starshipStartY = defaultWindowHeight - 50;
+
+// Default number of simulation steps per second
+const float defaultSimulationHz = 120.f;
+
+// The state of the player controls for a single simulation step.
+struct InputState
+{
+    bool left = false;
+    bool right = false;
+    bool up = false;
+    bool down = false;
+    bool fire = false;
+
+    // Enter: start a new game
+    bool start = false;
+
+    // A key was released since the previous step, which re-arms the one-shot controls
+    bool keyReleased = false;
+};
+
+class GameWorld
+{
+public:
+    // Number of body segments of the initial centipede
+    static const int NUM_CENTIPEDE_BODY = 11;
+
+    // Number of mushrooms generated for a new game
+    static const int NUM_MUSHROOMS = 30;
+
+    // Lives the player starts with
+    static const int START_LIVES = 2;
+
+    // Where the game currently is
+    enum class State { Title, Playing, Won, Lost };
+
+    // The independent random streams of a game, one per subsystem drawing random numbers.
+    // A subsystem never draws from the stream of another one, so the order they run in does not matter.
+    enum RandomStream { MushroomStream, SpiderStream };
+
+private:
+    // Memory of the centipedes, their segments and the mushrooms, released at once when a new game starts.
+    // Declared first, so it outlives the containers allocating from it.
+    LevelMemory m_LevelMemory;
+
+    // Game objects, the segments of all the centipedes are stored in m_Segments
+    SegmentArena m_Segments;
+    std::pmr::list<Centipede> m_Centipedes;
+    MushroomField m_Mushrooms;
+    LaserRing m_Lasers;
+    Starship m_Starship;
+    Spider m_Spider;
+    bool m_SpiderActive = true;
+
+    // Broadphase finding the overlaps between lasers, centipedes, spider and starship.
+    // Centipedes are tracked by their bounding box; their segments are only tested when the box overlaps.
+    SweepAndPrune m_Broadphase;
+
+    // Game status
+    State m_State = State::Title;
+    int m_Score = 0;
+    int m_Lives = START_LIVES;
+
+    // Control the player input
+    bool m_AcceptInput = false;
+
+    // Seed of the world, every random stream is derived from it
+    unsigned m_Seed;
+
+    // Random engine used to place the mushrooms
+    std::mt19937 m_Engine;
+
+    // Threads running the step, nullptr to run it on the calling thread
+    JobSystem* m_Jobs = nullptr;
+
+    // The phases of a step and the dependencies between them, declared once in buildStepGraph()
+    TaskGraph m_StepGraph;
+
+    // The time step being simulated, read by the phases
+    Time m_StepTime;
+
+    // The centipedes of the step, indexed for the parallel update
+    std::vector<Centipede*> m_UpdateList;
+
+    // Fewest centipedes updated in parallel, 0 to always update them on one thread, and centipedes per job
+    int m_ParallelCentipedes = 0;
+    int m_CentipedeChunk = 1;
+
+    // @brief Start a new game: reset the score, lives and all game objects.
+    void reset();
+
+    // @brief Remove the centipedes, their segments and the mushrooms, and release their memory at once.
+    void releaseLevel();
+
+    // @brief Apply the player controls to the starship and fire lasers.
+    // @param input The controls for this step.
+    void handleInput(const InputState& input);
+
+    // @brief Check whether the step is expensive enough to run on the job system.
+    // @return True if a job system is attached and there are enough centipedes to update them in parallel.
+    bool isParallelStep() const;
+
+    // @brief Declare the phases of a step and what each of them must wait for.
+    //        Two phases that are not ordered by the graph may run at the same time,
+    //        so they must not write anything the other one reads or writes.
+    void buildStepGraph();
+
+    // @brief Run a phase of the step, the function of its task in m_StepGraph.
+    // @param world The world.
+    template <void (GameWorld::*Phase)()>
+    static void runPhase(void* world)
+    {
+        (static_cast<GameWorld*>(world)->*Phase)();
+    }
+
+    // @brief Remember the position of every moving object as the start of a new step.
+    void savePositions();
+
+    // @brief Move the starship, which stops at the mushrooms.
+    void updateStarship();
+
+    // @brief Move every centipede, in parallel when enabled and there are enough of them.
+    //        Centipedes only read the mushroom field and write their own segments,
+    //        so the result does not depend on the number of threads.
+    void updateCentipedes();
+
+    // @brief Move the spider, or bring it back once it was shot.
+    void updateSpider();
+
+    // @brief Move the lasers.
+    void updateLasers();
+
+    // @brief Let the spider eat the mushrooms it walks over.
+    void eraseSpiderMushrooms();
+
+    // @brief Place NUM_MUSHROOMS mushrooms on distinct random cells of the playfield.
+    void generateMushrooms();
+
+    // @brief Give the current bounds of every moving object to the broadphase and find the overlapping pairs.
+    void updateBroadphase();
+
+    // @brief Shoot a centipede if a laser hits one of its segments.
+    // @param centipede The centipede.
+    // @param laser The slot of the laser, removed from the broadphase on a hit.
+    // @param bounds The bounds of the laser.
+    void hitCentipede(Centipede& centipede, int laser, const FloatRect& bounds);
+
+    // @brief Destroy the spider if a laser hits it.
+    void handleHitSpider();
+
+    // @brief Damage the first mushroom in the way of each laser.
+    void handleHitMushrooms();
+
+    // @brief Resolve the collisions between lasers and centipedes, splitting the centipedes that are hit.
+    void handleHitCentipede();
+
+    // @brief Erase the lasers that hit something during the step.
+    void eraseHitLasers();
+
+    // @brief Take a life when the spider or a centipede runs into the starship.
+    void handleHitStarship();
+
+    // @brief Erase the centipedes that were shot entirely, once the starship was tested against them.
+    void eraseShotCentipedes();
+
+    // @brief Check whether the game is won or lost.
+    void checkOutcome();
+
+public:
+    // Constructor that creates the starship, the spider and the first centipede.
+    // The game starts paused on the title screen.
+    // @param seed The seed of every random stream of the world.
+    explicit GameWorld(unsigned seed);
+
+    // The step graph refers to this world
+    GameWorld(const GameWorld&) = delete;
+    GameWorld& operator=(const GameWorld&) = delete;
+
+    // @brief Run the phases of the steps on a job system, once setParallelCentipedes() made them expensive enough.
+    // @param jobs The job system, it must outlive the world; nullptr to run on the calling thread.
+    void setJobSystem(JobSystem* jobs);
+
+    // @brief Update the centipedes in parallel on the job system once there are enough of them. Off by
+    //        default: a centipede takes a fraction of a microsecond to update, so a job only pays off when
+    //        it holds enough of them; Lab1Bench measures both costs on the machine to choose the values.
+    // @param minimum The fewest centipedes updated in parallel, 0 to always update them on one thread.
+    // @param chunk The number of centipedes of a job.
+    void setParallelCentipedes(int minimum, int chunk);
+
+    // @brief Advance the game by one step.
+    // @param dt The time elapsed since the last step.
+    // @param input The player controls for this step.
+    void step(Time dt, const InputState& input);
+
+    // @brief Derive the seed of a random stream from the seed of a world.
+    // @param seed The seed of the world.
+    // @param stream The stream.
+    // @return The seed of the engine of the stream.
+    static unsigned getStreamSeed(unsigned seed, RandomStream stream);
+
+    // @brief Get the seed the world was created with.
+    // @return The seed of the world.
+    unsigned getSeed() const;
+
+    // @brief Compute a hash of the complete state of the game, used to check that a replay plays the same game.
+    // @return A 64-bit FNV-1a hash of the positions, lives of the mushrooms, score, lives and state.
+    std::uint64_t getChecksum() const;
+
+    // @brief Save the complete state of the game, enough for a world created with any seed to continue exactly
+    //        like this one. The job system and the broadphase are not part of the state.
+    // @param buffer The state is appended to it.
+    void saveState(std::vector<char>& buffer) const;
+
+    // @brief Restore a state written by saveState.
+    // @param data The first byte of the state.
+    // @param size The number of bytes of the state.
+    // @return False if the state is malformed, the world must then be reset or discarded.
+    bool loadState(const char* data, size_t size);
+
+    // @brief Check whether the simulation is paused (title, win or game over screen).
+    // @return True if the game is not being played.
+    bool isPaused() const;
+
+    // @brief Get where the game currently is.
+    // @return The current state of the game.
+    State getState() const;
+
+    // @brief Get the current score.
+    // @return The score of the player.
+    int getScore() const;
+
+    // @brief Get the remaining lives.
+    // @return The number of spare starships.
+    int getLives() const;
+
+    // @brief Check whether the spider is alive.
+    // @return True if the spider should be drawn.
+    bool isSpiderActive() const;
+
+    // Accessors to the game objects, used for rendering
+    std::pmr::list<Centipede>& getCentipedes();
+    MushroomField& getMushrooms();
+    LaserRing& getLasers();
+    Starship& getStarship();
+    Spider& getSpider();
+
+    // Read-only accessors, used to inspect the world
+    const std::pmr::list<Centipede>& getCentipedes() const;
+    const MushroomField& getMushrooms() const;
+    const LaserRing& getLasers() const;
+
+    // @brief Get the graph of the phases of a step, with how long each phase took in the last step.
+    const TaskGraph& getStepGraph() const;
+};
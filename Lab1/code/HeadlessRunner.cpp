@@ -0,0 +1,369 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This is the entry point of the headless runner. It drives a GameWorld as fast as possible without
+opening a window, feeding it scripted pseudo-random input, and reports the simulation throughput.
+It is meant for soak tests and profiling on machines without a display; built with LAB1_PROFILE, it also
+reports the time spent in each phase of the steps and writes them to Lab1HeadlessTrace.json.
+The run can be recorded to a replay file, and a replay recorded here or by the game can be played back
+to check that it reproduces the recorded game exactly. Seeking jumps to a step of a replay through its
+keyframes and checks the result against playing every step up to it.
+
+A flight recorder keeps the timings of the last steps and writes them to Lab1Headlesshitch-<step>.csv
+when a step takes longer than the hitch budget, one step period by default. An empty replay name records
+no replay.
+Built with LAB1_PERF_COUNTERS, it reports the hardware counters of each phase and writes them per step to
+Lab1HeadlessCounters.csv.
+
+Usage: Lab1Headless [frames] [seed] [simulation Hz] [worker threads] [replay to record] [hitch budget in ms]
+       Lab1Headless --replay <replay file> [worker threads]
+       Lab1Headless --seek <replay file> <step> [worker threads]
+*/
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <SFML/Graphics.hpp>
+
+#include "AllocationCounter.h"
+#include "Assets.h"
+#include "FixedTimestep.h"
+#include "FlightRecorder.h"
+#include "GameWorld.h"
+#include "PerfCounters.h"
+#include "Profiler.h"
+#include "Replay.h"
+
+using namespace sf;
+
+// Scripted pseudo-random player: holds a random direction for a while and fires regularly.
+class InputScript
+{
+private:
+    std::mt19937 m_Engine;
+    int m_Direction = 0;
+    int m_HoldFrames = 0;
+
+public:
+    // @param seed Seed of the script, the same seed always plays the same way.
+    explicit InputScript(unsigned seed) : m_Engine(seed) {}
+
+    // @brief Produce the input of a frame.
+    // @param frame The frame number.
+    // @param world The game being played, used to restart it when it ends.
+    // @return The controls for this frame.
+    InputState next(long frame, const GameWorld& world)
+    {
+        InputState input;
+
+        // Start a new game whenever the previous one is over
+        input.start = world.isPaused();
+
+        // Pick a new direction every now and then
+        if (m_HoldFrames-- <= 0)
+        {
+            m_Direction = std::uniform_int_distribution<int>(0, 4)(m_Engine);
+            m_HoldFrames = std::uniform_int_distribution<int>(5, 60)(m_Engine);
+        }
+        input.left = m_Direction == 1;
+        input.right = m_Direction == 2;
+        input.up = m_Direction == 3;
+        input.down = m_Direction == 4;
+
+        // Press space and release a key on alternating frames
+        input.fire = frame % 2 == 0;
+        input.keyReleased = frame % 2 == 1;
+
+        return input;
+    }
+};
+
+// @brief Walk every render and collision accessor the way the draw pass of the game does.
+// @param world The game to walk.
+// @param alpha The interpolation factor used for the moving objects.
+// @return A checksum of the visited positions, so the walk cannot be optimized away.
+float visitDrawables(GameWorld& world, float alpha)
+{
+    float checksum = 0;
+
+    for (const Sprite& mushroom : world.getMushrooms())
+    {
+        checksum += mushroom.getPosition().x;
+    }
+
+    for (const Laser& laser : world.getLasers())
+    {
+        checksum += laser.getShape().getPosition().y + laser.getRenderOffset(alpha).y;
+    }
+
+    const Spider& spider = world.getSpider();
+    checksum += spider.getShape().getPosition().x + spider.getRenderOffset(alpha).x;
+
+    const Starship& starship = world.getStarship();
+    checksum += starship.getShape().getPosition().x + starship.getRenderOffset(alpha).x;
+
+    for (auto& centipede : world.getCentipedes())
+    {
+        for (const CentipedeComponent& segment : centipede.getSegments())
+        {
+            checksum += segment.getShape().getPosition().x + segment.getRenderOffset(alpha).x;
+        }
+
+        for (FloatRect bounds : centipede.getBounds())
+        {
+            checksum += bounds.left;
+        }
+    }
+
+    return checksum;
+}
+
+// @brief Play a replay back and compare the final world with the recorded one.
+// @param filename The replay file.
+// @param workers The number of worker threads of the job system.
+// @return 0 if the replay reproduced the recorded game, 1 otherwise.
+int playReplay(const std::string& filename, int workers)
+{
+    ReplayPlayer player;
+    if (!player.open(filename))
+    {
+        std::cerr << "cannot read replay " << filename << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs(workers);
+    GameWorld world(player.getSeed());
+    world.setJobSystem(&jobs);
+
+    Clock clock;
+    InputState input;
+    while (player.next(input))
+    {
+        world.step(player.getStep(), input);
+    }
+    Time elapsed = clock.getElapsedTime();
+
+    std::cout << "replay:        " << filename << "\n"
+              << "seed:          " << player.getSeed() << "\n"
+              << "steps:         " << player.getSteps() << "\n"
+              << "score:         " << world.getScore() << "\n"
+              << "elapsed (s):   " << elapsed.asSeconds() << std::endl;
+
+    if (!player.isComplete())
+    {
+        std::cerr << "replay is truncated" << std::endl;
+        return 1;
+    }
+
+    if (world.getChecksum() != player.getChecksum())
+    {
+        std::cerr << "replay diverged: checksum " << std::hex << world.getChecksum()
+                  << ", recorded " << player.getChecksum() << std::dec << std::endl;
+        return 1;
+    }
+
+    std::cout << "replay matches the recorded game" << std::endl;
+    return 0;
+}
+
+// @brief Seek to a step of a replay, then play the same steps one by one and compare both worlds.
+// @param filename The replay file.
+// @param step The step to seek to.
+// @param workers The number of worker threads of the job system.
+// @return 0 if seeking reached the same world as playing, 1 otherwise.
+int seekReplay(const std::string& filename, std::uint64_t step, int workers)
+{
+    ReplayPlayer player;
+    if (!player.open(filename))
+    {
+        std::cerr << "cannot read replay " << filename << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs(workers);
+    GameWorld world(player.getSeed());
+    world.setJobSystem(&jobs);
+
+    Clock clock;
+    if (!player.seek(step, world))
+    {
+        std::cerr << "cannot seek to step " << step << " of " << player.getTotalSteps() << std::endl;
+        return 1;
+    }
+    Time seekTime = clock.restart();
+
+    ReplayPlayer sequential;
+    sequential.open(filename);
+    GameWorld played(sequential.getSeed());
+    played.setJobSystem(&jobs);
+
+    InputState input;
+    while (sequential.getSteps() < step && sequential.next(input))
+    {
+        played.step(sequential.getStep(), input);
+    }
+    Time playTime = clock.getElapsedTime();
+
+    std::cout << "replay:        " << filename << "\n"
+              << "keyframes:     " << player.getKeyframeCount() << "\n"
+              << "step:          " << step << " of " << player.getTotalSteps() << "\n"
+              << "seek (ms):     " << seekTime.asMicroseconds() / 1000.f << "\n"
+              << "play (ms):     " << playTime.asMicroseconds() / 1000.f << std::endl;
+
+    if (world.getChecksum() != played.getChecksum())
+    {
+        std::cerr << "seek diverged: checksum " << std::hex << world.getChecksum()
+                  << ", played " << played.getChecksum() << std::dec << std::endl;
+        return 1;
+    }
+
+    std::cout << "seek matches the played game" << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // No window and no OpenGL context in this process
+    Assets::setHeadless(true);
+    Assets::preload();
+
+    if (argc > 2 && std::string(argv[1]) == "--replay")
+    {
+        return playReplay(argv[2], argc > 3 ? std::stoi(argv[3]) : 0);
+    }
+
+    if (argc > 3 && std::string(argv[1]) == "--seek")
+    {
+        return seekReplay(argv[2], std::stoull(argv[3]), argc > 4 ? std::stoi(argv[4]) : 0);
+    }
+
+    Profiler::setThreadName("simulation");
+
+    long frames = argc > 1 ? std::stol(argv[1]) : 100000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 1;
+    float hz = argc > 3 ? std::stof(argv[3]) : defaultSimulationHz;
+    int workers = argc > 4 ? std::stoi(argv[4]) : 0;
+
+    if (!FixedTimestep::isValidRate(hz))
+    {
+        std::cerr << "simulation rate must be above 0 and at most " << static_cast<long>(FixedTimestep::MAX_HZ) << " Hz" << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs(workers);
+    GameWorld world(seed);
+    world.setJobSystem(&jobs);
+    InputScript script(seed);
+    Time dt = FixedTimestep::stepFor(hz);
+
+    ReplayRecorder recorder;
+    if (argc > 5 && *argv[5] && !recorder.open(argv[5], world, dt))
+    {
+        std::cerr << "cannot write replay " << argv[5] << std::endl;
+        return 1;
+    }
+
+    FlightRecorder flightRecorder(argc > 6 ? seconds(std::stof(argv[6]) / 1000) : dt, "Lab1Headless");
+
+    // Hardware counters of every phase, per step and in total
+    PerfReport perfReport;
+    std::ofstream perfTicks;
+    if (PerfCounters::isEnabled())
+    {
+        perfTicks.open("Lab1HeadlessCounters.csv", std::ios::trunc);
+        perfReport.setTickStream(&perfTicks);
+    }
+
+    int games = 0;
+    long highScore = 0;
+
+    // Allocations made by the accessors and by the flight recorder when it does not dump, must stay at zero
+    long accessorAllocations = 0;
+    long recorderAllocations = 0;
+    float checksum = 0;
+
+    Clock clock;
+    for (long frame = 0; frame < frames; frame++)
+    {
+        InputState input = script.next(frame, world);
+        if (input.start)
+        {
+            games++;
+        }
+
+        {
+            PROFILE_SCOPE("step");
+            flightRecorder.beginStep();
+            world.step(dt, input);
+
+            long allocations = AllocationCounter::getCount();
+            if (!flightRecorder.endStep(world))
+            {
+                recorderAllocations += AllocationCounter::getCount() - allocations;
+            }
+        }
+        if (PerfCounters::isEnabled())
+        {
+            perfReport.add(world.getStepGraph());
+        }
+        if (recorder.isOpen())
+        {
+            recorder.record(input, world);
+        }
+
+        long allocations = AllocationCounter::getCount();
+        checksum += visitDrawables(world, .5f);
+        accessorAllocations += AllocationCounter::getCount() - allocations;
+
+        if (world.getScore() > highScore)
+        {
+            highScore = world.getScore();
+        }
+
+        AllocationCounter::endFrame();
+    }
+    Time elapsed = clock.getElapsedTime();
+
+    if (recorder.isOpen() && !recorder.close(world))
+    {
+        std::cerr << "cannot write replay " << argv[5] << std::endl;
+        return 1;
+    }
+
+    std::cout << "frames:        " << frames << "\n"
+              << "games:         " << games << "\n"
+              << "high score:    " << highScore << "\n"
+              << "checksum:      " << std::hex << world.getChecksum() << std::dec << "\n"
+              << "elapsed (s):   " << elapsed.asSeconds() << "\n"
+              << "frames/second: " << frames / elapsed.asSeconds() << "\n"
+              << "hitches:       " << flightRecorder.getHitches() << " (" << flightRecorder.getDumps() << " written)" << std::endl;
+    Assets::printStats(std::cout);
+
+    if (AllocationCounter::isEnabled())
+    {
+        std::cout << "accessor allocations: " << accessorAllocations
+                  << " (checksum " << checksum << ")" << std::endl;
+        std::cout << "flight recorder allocations: " << recorderAllocations << std::endl;
+        AllocationCounter::writeReport(std::cout);
+    }
+
+    if (PerfCounters::isEnabled())
+    {
+        perfReport.writeReport(std::cout);
+    }
+
+    if (Profiler::isEnabled())
+    {
+        Profiler::writeReport(std::cout);
+        if (Profiler::writeChromeTrace("Lab1HeadlessTrace.json"))
+        {
+            std::cout << "trace written to Lab1HeadlessTrace.json" << std::endl;
+        }
+    }
+
+    return 0;
+}
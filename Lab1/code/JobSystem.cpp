@@ -0,0 +1,234 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the JobSystem class. Each queue is a ring guarded by its own mutex; the owner and the
+thieves rarely touch the same queue at the same time, so the locks are almost never contended.
+A thread waiting for a counter only runs the jobs of that counter, taking them out of the middle of a queue
+if needed; the queues are short, so the search costs little.
+Idle workers sleep on a condition variable until a job is queued anywhere.
+*/
+
+#include "JobSystem.h"
+#include "Profiler.h"
+
+// The system and the queue of the calling thread, set for the threads of a system
+thread_local const JobSystem* t_System = nullptr;
+thread_local int t_Queue = 0;
+
+// Constructor that starts the worker threads.
+// @param workers The number of threads started besides the calling thread.
+JobSystem::JobSystem(int workers)
+{
+    for (int i = 0; i <= workers; i++)
+    {
+        m_Queues.push_back(std::make_unique<Queue>());
+    }
+
+    t_System = this;
+    t_Queue = 0;
+
+    for (int i = 1; i <= workers; i++)
+    {
+        m_Workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+// Stops and joins the worker threads.
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_all();
+
+    for (std::thread& worker : m_Workers)
+    {
+        worker.join();
+    }
+
+    if (t_System == this)
+    {
+        t_System = nullptr;
+    }
+}
+
+// @brief Get the number of worker threads.
+// @return The number of threads besides the calling thread.
+int JobSystem::getWorkers() const
+{
+    return static_cast<int>(m_Workers.size());
+}
+
+// @brief Get the queue of the calling thread. Threads foreign to the system share queue 0.
+int JobSystem::getQueueIndex() const
+{
+    return t_System == this ? t_Queue : 0;
+}
+
+// @brief Queue a job on the queue of the calling thread.
+// @return False if the queue is full.
+bool JobSystem::push(const Job& job)
+{
+    Queue& queue = *m_Queues[getQueueIndex()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.size == QUEUE_CAPACITY)
+    {
+        return false;
+    }
+
+    queue.jobs[(queue.front + queue.size) % QUEUE_CAPACITY] = job;
+    queue.size++;
+    m_Queued++;
+    return true;
+}
+
+// @brief Remove a job from a queue, its lock held.
+// @param queue The queue.
+// @param position The position of the job from the front of the queue.
+// @return The job.
+JobSystem::Job JobSystem::removeAt(Queue& queue, int position)
+{
+    Job job = queue.jobs[(queue.front + position) % QUEUE_CAPACITY];
+
+    // The jobs behind it move up, keeping their order
+    for (int i = position + 1; i < queue.size; i++)
+    {
+        queue.jobs[(queue.front + i - 1) % QUEUE_CAPACITY] = queue.jobs[(queue.front + i) % QUEUE_CAPACITY];
+    }
+    queue.size--;
+    return job;
+}
+
+// @brief Take the newest job of a queue.
+// @param counter Only take a job submitted with this counter, nullptr for any job.
+bool JobSystem::pop(int index, Job& job, const Counter* counter)
+{
+    Queue& queue = *m_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (int i = queue.size - 1; i >= 0; i--)
+    {
+        if (!counter || queue.jobs[(queue.front + i) % QUEUE_CAPACITY].counter == counter)
+        {
+            job = removeAt(queue, i);
+            m_Queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// @brief Take the oldest job of another queue, trying the queues after the thief's first.
+// @param counter Only take a job submitted with this counter, nullptr for any job.
+bool JobSystem::steal(int thief, Job& job, const Counter* counter)
+{
+    int count = static_cast<int>(m_Queues.size());
+    for (int i = 1; i < count; i++)
+    {
+        Queue& queue = *m_Queues[(thief + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (int j = 0; j < queue.size; j++)
+        {
+            if (!counter || queue.jobs[(queue.front + j) % QUEUE_CAPACITY].counter == counter)
+            {
+                job = removeAt(queue, j);
+                m_Queued--;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// @brief Run a job and count it as finished.
+void JobSystem::execute(const Job& job)
+{
+    job.function(job.context, job.index);
+    job.counter->m_Pending.fetch_sub(1, std::memory_order_release);
+}
+
+// @brief Run one queued job, the calling thread's own first.
+// @param counter Only run a job submitted with this counter, nullptr for any job.
+// @return False if no such job is queued.
+bool JobSystem::runOne(const Counter* counter)
+{
+    if (m_Queued.load() == 0)
+    {
+        return false;
+    }
+
+    int index = getQueueIndex();
+    Job job;
+    if (pop(index, job, counter) || steal(index, job, counter))
+    {
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+// @brief Run jobs until the system is destroyed.
+// @param index The queue of the worker.
+void JobSystem::workerLoop(int index)
+{
+    t_System = this;
+    t_Queue = index;
+    Profiler::setThreadName("worker " + std::to_string(index));
+
+    for (;;)
+    {
+        if (runOne(nullptr))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Wake.wait(lock, [this] { return m_Stop || m_Queued.load() > 0; });
+        if (m_Stop)
+        {
+            return;
+        }
+    }
+}
+
+// @brief Submit a job. It may run on any thread of the system, before or after submit() returns.
+// @param function The function of the job.
+// @param context Passed to the function.
+// @param index Passed to the function.
+// @param counter Incremented now and decremented once the job finished.
+void JobSystem::submit(JobFunction function, void* context, int index, Counter& counter)
+{
+    counter.m_Pending.fetch_add(1);
+    Job job = { function, context, index, &counter };
+
+    // Nobody else would run it
+    if (m_Workers.empty() || !push(job))
+    {
+        execute(job);
+        return;
+    }
+
+    // Taking the lock orders the push before a worker checking the queues goes to sleep
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_Wake.notify_one();
+}
+
+// @brief Run queued jobs on the calling thread until every job of a counter finished.
+//        A task of a graph waiting for its parallel loop would otherwise run the other tasks of the graph,
+//        and their time would be charged to it.
+// @param counter The counter the jobs were submitted with.
+void JobSystem::wait(Counter& counter)
+{
+    while (counter.m_Pending.load(std::memory_order_acquire) > 0)
+    {
+        if (!runOne(&counter))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
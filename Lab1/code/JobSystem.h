@@ -0,0 +1,179 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the JobSystem class, a work-stealing job scheduler. Every thread of the system,
+the thread that created it included, owns a queue of jobs. A thread pushes and pops jobs at the back of
+its own queue and, when it runs dry, steals the oldest job at the front of another queue, so a thread
+that submits a lot of work keeps its cache warm while the idle threads balance the load.
+A job is a function pointer, a context and an index, so submitting one never allocates.
+*/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    // The function of a job, called with the context and the index it was submitted with
+    typedef void (*JobFunction)(void* context, int index);
+
+    // Counts the unfinished jobs submitted with it, wait() returns once it reaches zero
+    class Counter
+    {
+    private:
+        std::atomic<int> m_Pending{ 0 };
+        friend class JobSystem;
+
+    public:
+        // @brief Check whether every job submitted with the counter has finished.
+        // @return True if no job is pending.
+        bool isDone() const { return m_Pending.load() == 0; }
+    };
+
+    // Jobs a queue holds; a thread runs a job right away rather than overflow its queue
+    static const int QUEUE_CAPACITY = 1024;
+
+private:
+    struct Job
+    {
+        JobFunction function;
+        void* context;
+        int index;
+        Counter* counter;
+    };
+
+    // A fixed ring of jobs. The owner works at the back, thieves take from the front.
+    struct Queue
+    {
+        std::mutex mutex;
+        Job jobs[QUEUE_CAPACITY];
+        int front = 0;
+        int size = 0;
+    };
+
+    // Queue 0 belongs to the thread that created the system, queue i to worker i
+    std::vector<std::unique_ptr<Queue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+
+    // Jobs waiting in any queue, the workers sleep while there is none
+    std::atomic<int> m_Queued{ 0 };
+    bool m_Stop = false;
+    std::mutex m_SleepMutex;
+    std::condition_variable m_Wake;
+
+    // @brief Get the queue of the calling thread. Threads foreign to the system share queue 0.
+    int getQueueIndex() const;
+
+    // @brief Queue a job on the queue of the calling thread.
+    // @return False if the queue is full.
+    bool push(const Job& job);
+
+    // @brief Take the newest job of a queue.
+    // @param counter Only take a job submitted with this counter, nullptr for any job.
+    bool pop(int index, Job& job, const Counter* counter);
+
+    // @brief Take the oldest job of another queue, trying the queues after the thief's first.
+    // @param counter Only take a job submitted with this counter, nullptr for any job.
+    bool steal(int thief, Job& job, const Counter* counter);
+
+    // @brief Remove a job from a queue, its lock held.
+    // @param queue The queue.
+    // @param position The position of the job from the front of the queue.
+    // @return The job.
+    static Job removeAt(Queue& queue, int position);
+
+    // @brief Run a job and count it as finished.
+    void execute(const Job& job);
+
+    // @brief Run one queued job, the calling thread's own first.
+    // @param counter Only run a job submitted with this counter, nullptr for any job.
+    // @return False if no such job is queued.
+    bool runOne(const Counter* counter);
+
+    // @brief Run jobs until the system is destroyed.
+    // @param index The queue of the worker.
+    void workerLoop(int index);
+
+public:
+    // Constructor that starts the worker threads.
+    // @param workers The number of threads started besides the calling thread, 0 runs every job on the thread waiting for it.
+    explicit JobSystem(int workers);
+
+    // Stops and joins the worker threads. No job may be pending.
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // @brief Get the number of worker threads.
+    // @return The number of threads besides the calling thread.
+    int getWorkers() const;
+
+    // @brief Submit a job. It may run on any thread of the system, before or after submit() returns.
+    // @param function The function of the job.
+    // @param context Passed to the function, it must stay valid until the job finished.
+    // @param index Passed to the function.
+    // @param counter Incremented now and decremented once the job finished.
+    void submit(JobFunction function, void* context, int index, Counter& counter);
+
+    // @brief Run queued jobs on the calling thread until every job of a counter finished.
+    //        Only the jobs of the counter are run, so the time a job spends waiting for its own jobs never
+    //        includes unrelated jobs.
+    // @param counter The counter the jobs were submitted with.
+    void wait(Counter& counter);
+
+    // @brief Run body(begin, end) over chunks of [0, count) in parallel and wait for all of them.
+    //        The iterations must be independent of each other. It may be called from inside a job.
+    // @param count The number of iterations.
+    // @param chunk The number of iterations of a job.
+    // @param body The callable run on each chunk.
+    template <class Body>
+    void parallelFor(int count, int chunk, Body& body)
+    {
+        chunk = chunk < 1 ? 1 : chunk;
+        if (count <= 0)
+        {
+            return;
+        }
+
+        // Not worth a job
+        if (m_Workers.empty() || count <= chunk)
+        {
+            body(0, count);
+            return;
+        }
+
+        struct Loop
+        {
+            Body* body;
+            int count;
+            int chunk;
+        } loop = { &body, count, chunk };
+
+        JobFunction runChunk = [](void* context, int index)
+        {
+            Loop* loop = static_cast<Loop*>(context);
+            int begin = index * loop->chunk;
+            int end = begin + loop->chunk < loop->count ? begin + loop->chunk : loop->count;
+            (*loop->body)(begin, end);
+        };
+
+        // Queue every chunk but the first, which the calling thread starts with
+        Counter counter;
+        int chunks = (count + chunk - 1) / chunk;
+        for (int i = chunks - 1; i > 0; i--)
+        {
+            submit(runChunk, &loop, i, counter);
+        }
+        runChunk(&loop, 0);
+        wait(counter);
+    }
+};
@@ -1,51 +1,148 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This file contains the implementation of the Laser class, which represents the laser shot by the starship in the game.
-It handles the laser's creation, movement, and interactions within the game (e.g., collision detection with other objects).
-*/
-
-#include "Laser.h"
-
-// This is the constructor and it is called when we create an object
-// @param startX The starting x-coordinate for the laser.
-// @param startY The starting y-coordinate for the laser.
-Laser::Laser(float startX, float startY)
-{
-    // Set the initial position of the laser
-    m_Position.x = startX;
-    m_Position.y = startY;
-
-    // Set up the laser shape
-    m_Shape.setSize(sf::Vector2f(width, length));
-    m_Shape.setPosition(m_Position);
-    m_Shape.setFillColor(Color::Red);
-}
-
-// @brief Get the global bounding box of the laser.
-// @return A FloatRect representing the global bounds of the laser for collision detection.
-FloatRect Laser::getPosition()
-{
-    return m_Shape.getGlobalBounds();
-}
-
-// @brief Get the shape of the laser for rendering.
-// @return A RectangleShape object representing the laser's shape.
-RectangleShape Laser::getShape()
-{
-    return m_Shape;
-}
-
-// @brief Update the laser's position based on the elapsed time.
-// @param dt The elapsed time since the last frame, used to calculate how far the laser should move.
-void Laser::update(Time dt)
-{
-    // Move the laser upward based on its speed and the time delta
-    m_Position.y -= m_Speed * dt.asSeconds();
-
-    // Update the laser's shape position
-    m_Shape.setPosition(m_Position);
-}
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file contains the implementation of the Laser class, which represents the laser shot by the starship in the game.
+It handles the laser's creation, movement, and interactions within the game (e.g., collision detection with other objects).
+*/
+
+#include "Laser.h"
+
+// This is the constructor and it is called when we create an object
+// @param startX The starting x-coordinate for the laser.
+// @param startY The starting y-coordinate for the laser.
+Laser::Laser(float startX, float startY)
+{
+    // Set up the laser shape
+    m_Shape.setSize(sf::Vector2f(width, length));
+    m_Shape.setFillColor(Color::Red);
+
+    reset(startX, startY);
+}
+
+// @brief Fire the laser again from a new position, reusing its shape.
+// @param startX The starting x-coordinate of the laser.
+// @param startY The starting y-coordinate of the laser.
+void Laser::reset(float startX, float startY)
+{
+    // Set the initial position of the laser
+    m_Position.x = startX;
+    m_Position.y = startY;
+    m_Shape.setPosition(m_Position);
+    m_PreviousPosition = m_Position;
+    m_Speed = 1000.0f;
+
+    // The target is found once the laser is placed
+    m_TargetColumn = -1;
+    m_TargetRow = -1;
+    m_TargetBottom = 0;
+    m_TargetVersion = 0;
+    m_TargetResolved = false;
+}
+
+// @brief Get the global bounding box of the laser.
+// @return A FloatRect representing the global bounds of the laser for collision detection.
+FloatRect Laser::getPosition() const
+{
+    return m_Shape.getGlobalBounds();
+}
+
+// @brief Get the shape of the laser for rendering.
+// @return A reference to the rectangle representing the laser's shape.
+const RectangleShape& Laser::getShape() const
+{
+    return m_Shape;
+}
+
+// @brief Update the laser's position based on the elapsed time.
+// @param dt The elapsed time since the last frame, used to calculate how far the laser should move.
+void Laser::update(Time dt)
+{
+    // Move the laser upward based on its speed and the time delta
+    m_Position.y -= m_Speed * dt.asSeconds();
+
+    // Update the laser's shape position
+    m_Shape.setPosition(m_Position);
+}
+
+// @brief Find the first mushroom in the way of the laser.
+// @param mushrooms The mushroom field.
+void Laser::resolveTarget(const MushroomField& mushrooms)
+{
+    FloatRect bounds = getPosition();
+    m_TargetVersion = mushrooms.getColumnsVersion(bounds);
+    m_TargetResolved = true;
+
+    if (!mushrooms.findFirstAbove(bounds, m_TargetColumn, m_TargetRow))
+    {
+        m_TargetRow = -1;
+        return;
+    }
+
+    FloatRect target = mushrooms.getBounds(mushrooms.getAt(m_TargetColumn, m_TargetRow));
+    m_TargetBottom = target.top + target.height;
+}
+
+// @brief Get the mushroom hit by the laser. A mushroom the laser went past during a long step is still hit.
+// @param mushrooms The mushroom field.
+// @return The index of the mushroom, or MushroomField::EMPTY if the laser has not reached any mushroom yet.
+int Laser::findMushroomHit(const MushroomField& mushrooms)
+{
+    // The target is only looked up again when a mushroom of the columns was added or removed
+    if (!m_TargetResolved || mushrooms.getColumnsVersion(getPosition()) != m_TargetVersion)
+    {
+        resolveTarget(mushrooms);
+    }
+
+    if (m_TargetRow < 0 || m_Position.y >= m_TargetBottom)
+    {
+        return MushroomField::EMPTY;
+    }
+    return mushrooms.getAt(m_TargetColumn, m_TargetRow);
+}
+
+// @brief Remember the current position as the start of a new simulation step.
+void Laser::savePosition()
+{
+    m_PreviousPosition = m_Shape.getPosition();
+}
+
+// @brief Get the offset from the simulated position to the interpolated render position.
+// @param alpha How far the frame is between the previous and the current step, in [0, 1].
+// @return The translation to apply when drawing.
+Vector2f Laser::getRenderOffset(float alpha) const
+{
+    return (m_PreviousPosition - m_Shape.getPosition()) * (1.f - alpha);
+}
+
+// @brief Save the complete state of the laser, its target included.
+// @param writer The state being written.
+void Laser::saveState(StateWriter& writer) const
+{
+    writer.write(m_Position);
+    writer.write(m_Speed);
+    writer.write(m_PreviousPosition);
+    writer.write(m_TargetColumn);
+    writer.write(m_TargetRow);
+    writer.write(m_TargetBottom);
+    writer.write(m_TargetVersion);
+    writer.write(m_TargetResolved);
+    writer.writeTransform(m_Shape);
+}
+
+// @brief Restore a state written by saveState.
+// @param reader The state being read.
+void Laser::loadState(StateReader& reader)
+{
+    reader.read(m_Position);
+    reader.read(m_Speed);
+    reader.read(m_PreviousPosition);
+    reader.read(m_TargetColumn);
+    reader.read(m_TargetRow);
+    reader.read(m_TargetBottom);
+    reader.read(m_TargetVersion);
+    reader.read(m_TargetResolved);
+    reader.readTransform(m_Shape);
+}
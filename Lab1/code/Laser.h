@@ -1,50 +1,98 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This header file defines the Laser class, which represents the laser shot by the player’s starship.
-The laser moves upward at a constant speed and can interact with other game objects through collisions.
-*/
-
-#pragma once
-#include <SFML/Graphics.hpp>
-
-using namespace sf;
-
-class Laser
-{
-public:
-    // Constants for laser dimensions
-    static const int width = 3;
-    static const int length = 75;
-
-private:
-    // The position of the laser
-    Vector2f m_Position;
-
-    // The shape of the laser, represented as a RectangleShape
-    RectangleShape m_Shape;
-
-    // The speed at which the laser moves
-    float m_Speed = 1000.0f;
-
-public:
-    // Constructor to initialize the laser with a starting position
-    // @param startX The starting x-coordinate of the laser.
-    // @param startY The starting y-coordinate of the laser.
-    Laser(float startX, float startY);
-
-    // @brief Get the global bounding box of the laser for collision detection.
-    // @return A FloatRect representing the laser's global bounds.
-    FloatRect getPosition();
-
-    // @brief Get the shape of the laser for rendering.
-    // @return A RectangleShape object representing the laser.
-    RectangleShape getShape();
-
-    // @brief Update the laser's position based on the elapsed time.
-    // @param dt The time elapsed since the last frame.
-    void update(Time dt);
-};
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the Laser class, which represents the laser shot by the player’s starship.
+The laser moves upward at a constant speed and can interact with other game objects through collisions.
+Since the laser keeps its x-coordinate and mushrooms never move, the mushroom it will hit is found once,
+when the laser is fired, and only looked up again when a mushroom of its columns is added or removed.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "MushroomField.h"
+#include "StateStream.h"
+
+using namespace sf;
+
+class Laser
+{
+public:
+    // Constants for laser dimensions
+    static const int width = 3;
+    static const int length = 75;
+
+private:
+    // The position of the laser
+    Vector2f m_Position;
+
+    // The shape of the laser, represented as a RectangleShape
+    RectangleShape m_Shape;
+
+    // The speed at which the laser moves
+    float m_Speed = 1000.0f;
+
+    // Position drawn at the start of the current simulation step, used to interpolate rendering
+    Vector2f m_PreviousPosition;
+
+    // Cell of the first mushroom in the way, m_TargetRow is -1 when nothing is in the way
+    int m_TargetColumn = -1;
+    int m_TargetRow = -1;
+
+    // The laser hits the target once its top goes above this y-coordinate
+    float m_TargetBottom = 0;
+
+    // Version of the mushroom columns the target was found with
+    unsigned m_TargetVersion = 0;
+    bool m_TargetResolved = false;
+
+public:
+    // Constructor to initialize the laser with a starting position
+    // @param startX The starting x-coordinate of the laser.
+    // @param startY The starting y-coordinate of the laser.
+    Laser(float startX, float startY);
+
+    // @brief Fire the laser again from a new position, reusing its shape.
+    // @param startX The starting x-coordinate of the laser.
+    // @param startY The starting y-coordinate of the laser.
+    void reset(float startX, float startY);
+
+    // @brief Get the global bounding box of the laser for collision detection.
+    // @return A FloatRect representing the laser's global bounds.
+    FloatRect getPosition() const;
+
+    // @brief Get the shape of the laser for rendering.
+    // @return A reference to the rectangle representing the laser.
+    const RectangleShape& getShape() const;
+
+    // @brief Update the laser's position based on the elapsed time.
+    // @param dt The time elapsed since the last frame.
+    void update(Time dt);
+
+    // @brief Find the first mushroom in the way of the laser.
+    // @param mushrooms The mushroom field.
+    void resolveTarget(const MushroomField& mushrooms);
+
+    // @brief Get the mushroom hit by the laser. A mushroom the laser went past during a long step is still hit.
+    // @param mushrooms The mushroom field.
+    // @return The index of the mushroom, or MushroomField::EMPTY if the laser has not reached any mushroom yet.
+    int findMushroomHit(const MushroomField& mushrooms);
+
+    // @brief Remember the current position as the start of a new simulation step.
+    void savePosition();
+
+    // @brief Get the offset from the simulated position to the interpolated render position.
+    // @param alpha How far the frame is between the previous and the current step, in [0, 1].
+    // @return The translation to apply when drawing.
+    Vector2f getRenderOffset(float alpha) const;
+
+    // @brief Save the complete state of the laser, its target included.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Restore a state written by saveState.
+    // @param reader The state being read.
+    void loadState(StateReader& reader);
+};
@@ -0,0 +1,131 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the LaserRing class.
+*/
+
+#include <algorithm>
+
+#include "AllocationCounter.h"
+#include "LaserRing.h"
+
+// Constructor that allocates the slots.
+// @param capacity The number of slots.
+LaserRing::LaserRing(int capacity)
+{
+    AllocationCounter::Tag tag(AllocationCounter::Lasers);
+    m_Slots.assign(std::max(capacity, 1), Laser(0.f, 0.f));
+    m_Alive.assign(m_Slots.size(), false);
+}
+
+// @brief Move the live lasers to the first slots, in order.
+void LaserRing::compact()
+{
+    int next = 0;
+    for (int i = m_Head; i < m_Tail; i++)
+    {
+        if (m_Alive[i])
+        {
+            if (i != next)
+            {
+                // The shapes have the same number of vertices, copying one reuses the memory of the other
+                m_Slots[next] = m_Slots[i];
+                m_Alive[next] = true;
+                m_Alive[i] = false;
+            }
+            next++;
+        }
+    }
+
+    m_Head = 0;
+    m_Tail = next;
+}
+
+// @brief Skip the tombstones at the head, and start over at the first slot once the ring is empty.
+void LaserRing::trimHead()
+{
+    while (m_Head < m_Tail && !m_Alive[m_Head])
+    {
+        m_Head++;
+    }
+
+    if (m_Head == m_Tail)
+    {
+        m_Head = 0;
+        m_Tail = 0;
+    }
+}
+
+// @brief Fire a laser, at the tail of the ring.
+// @param startX The starting x-coordinate of the laser.
+// @param startY The starting y-coordinate of the laser.
+// @return The new laser.
+Laser& LaserRing::push(float startX, float startY)
+{
+    if (m_Tail == static_cast<int>(m_Slots.size()))
+    {
+        compact();
+    }
+
+    if (m_Tail == static_cast<int>(m_Slots.size()))
+    {
+        // Every slot holds a laser in flight, only happens at very high simulation rates
+        AllocationCounter::Tag tag(AllocationCounter::Lasers);
+        m_Slots.resize(m_Slots.size() * 2, Laser(0.f, 0.f));
+        m_Alive.resize(m_Slots.size(), false);
+    }
+
+    Laser& laser = m_Slots[m_Tail];
+    laser.reset(startX, startY);
+    m_Alive[m_Tail] = true;
+    m_Tail++;
+    m_Size++;
+    return laser;
+}
+
+// @brief Get the oldest laser.
+// @return The laser at the head, the ring must not be empty.
+Laser& LaserRing::front()
+{
+    return m_Slots[m_Head];
+}
+
+// @brief Retire the oldest laser.
+void LaserRing::popFront()
+{
+    m_Alive[m_Head] = false;
+    m_Size--;
+    trimHead();
+}
+
+// @brief Retire every laser.
+void LaserRing::clear()
+{
+    std::fill(m_Alive.begin(), m_Alive.end(), false);
+    m_Head = 0;
+    m_Tail = 0;
+    m_Size = 0;
+}
+
+// @brief Get the number of lasers in flight.
+int LaserRing::size() const
+{
+    return m_Size;
+}
+
+// @brief Get the number of slots.
+int LaserRing::getCapacity() const
+{
+    return static_cast<int>(m_Slots.size());
+}
+
+// @brief Get the slot of a laser in flight, which no other laser in flight uses.
+// @param laser The laser, from this ring.
+// @return The index of the slot, below getCapacity().
+int LaserRing::getSlot(const Laser& laser) const
+{
+    return static_cast<int>(&laser - m_Slots.data());
+}
@@ -0,0 +1,135 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the LaserRing class, the store of the lasers in flight. Lasers all move at the same
+speed, so they mostly leave the screen in the order they were fired: the ring appends new lasers at its tail
+and retires old ones from its head. A laser that hits something in the middle becomes a tombstone, skipped by
+iteration, and the ring is compacted once tombstones outnumber the lasers or the tail reaches the end of the
+slots. Compacting moves the live lasers back to the first slot instead of wrapping around, so the lasers
+always lie in one contiguous range, in the order they were fired.
+The slots are allocated up front and reused, so firing and retiring lasers allocate nothing; only firing
+more lasers than there are slots grows the ring. The slot of a laser is also its key in the broadphase, which
+the world sizes for every slot, so a shot allocates nothing in the broadphase either.
+*/
+
+#pragma once
+#include <vector>
+
+#include "Laser.h"
+
+class LaserRing
+{
+public:
+    // Slots allocated by default, several times the lasers the game can have in flight
+    static const int DEFAULT_CAPACITY = 256;
+
+    // Iterates over the live lasers in the order they were fired
+    template <class Ring, class Value>
+    class Iterator
+    {
+    private:
+        Ring* m_Ring;
+        int m_Index;
+
+    public:
+        Iterator(Ring* ring, int index) : m_Ring(ring), m_Index(index) {}
+
+        Value& operator*() const { return m_Ring->m_Slots[m_Index]; }
+        Value* operator->() const { return &m_Ring->m_Slots[m_Index]; }
+
+        Iterator& operator++()
+        {
+            do
+            {
+                m_Index++;
+            } while (m_Index < m_Ring->m_Tail && !m_Ring->m_Alive[m_Index]);
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_Index == other.m_Index; }
+        bool operator!=(const Iterator& other) const { return m_Index != other.m_Index; }
+    };
+
+    typedef Iterator<LaserRing, Laser> iterator;
+    typedef Iterator<const LaserRing, const Laser> const_iterator;
+
+private:
+    std::vector<Laser> m_Slots;
+    std::vector<unsigned char> m_Alive;
+
+    // The slots in use are [m_Head, m_Tail), m_Head is always a live laser unless the ring is empty
+    int m_Head = 0;
+    int m_Tail = 0;
+    int m_Size = 0;
+
+    // @brief Move the live lasers to the first slots, in order.
+    void compact();
+
+    // @brief Skip the tombstones at the head, and start over at the first slot once the ring is empty.
+    void trimHead();
+
+public:
+    // Constructor that allocates the slots.
+    // @param capacity The number of slots.
+    explicit LaserRing(int capacity = DEFAULT_CAPACITY);
+
+    // @brief Fire a laser, at the tail of the ring.
+    // @param startX The starting x-coordinate of the laser.
+    // @param startY The starting y-coordinate of the laser.
+    // @return The new laser.
+    Laser& push(float startX, float startY);
+
+    // @brief Get the oldest laser.
+    // @return The laser at the head, the ring must not be empty.
+    Laser& front();
+
+    // @brief Retire the oldest laser.
+    void popFront();
+
+    // @brief Retire the lasers matching a predicate, keeping the others in order.
+    // @param predicate Called with each live laser, true to retire it.
+    template <class Predicate>
+    void eraseIf(Predicate predicate)
+    {
+        for (int i = m_Head; i < m_Tail; i++)
+        {
+            if (m_Alive[i] && predicate(static_cast<const Laser&>(m_Slots[i])))
+            {
+                m_Alive[i] = false;
+                m_Size--;
+            }
+        }
+
+        trimHead();
+
+        // Compact before the tombstones make iterating slower than the lasers justify
+        int tombstones = m_Tail - m_Head - m_Size;
+        if (tombstones > m_Size && tombstones >= 16)
+        {
+            compact();
+        }
+    }
+
+    // @brief Retire every laser.
+    void clear();
+
+    // @brief Get the number of lasers in flight.
+    int size() const;
+
+    // @brief Get the number of slots.
+    int getCapacity() const;
+
+    // @brief Get the slot of a laser in flight, which no other laser in flight uses.
+    //        A laser keeps its slot until the ring is compacted.
+    // @param laser The laser, from this ring.
+    // @return The index of the slot, below getCapacity().
+    int getSlot(const Laser& laser) const;
+
+    iterator begin() { return iterator(this, m_Head); }
+    iterator end() { return iterator(this, m_Tail); }
+    const_iterator begin() const { return const_iterator(this, m_Head); }
+    const_iterator end() const { return const_iterator(this, m_Tail); }
+};
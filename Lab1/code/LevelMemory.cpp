@@ -0,0 +1,34 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the LevelMemory class, the pools and arena the objects of a game are allocated from.
+*/
+
+#include "LevelMemory.h"
+
+// Constructor that allocates the buffer of the arena.
+// @param bufferSize The number of bytes of the buffer.
+LevelMemory::LevelMemory(std::size_t bufferSize)
+    : m_Buffer(new std::byte[bufferSize]),
+      m_Arena(m_Buffer.get(), bufferSize),
+      m_Pools(&m_Arena)
+{
+}
+
+// @brief Get the memory resource the containers of a game allocate from.
+// @return The pools.
+std::pmr::memory_resource* LevelMemory::getResource()
+{
+    return &m_Pools;
+}
+
+// @brief Free everything allocated since the last release at once.
+void LevelMemory::release()
+{
+    // The pools give their chunks back to the arena, which ignores it, then the arena starts over in the buffer
+    m_Pools.release();
+    m_Arena.release();
+}
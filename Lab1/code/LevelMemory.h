@@ -0,0 +1,53 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the LevelMemory class, the memory the objects of one game are allocated from.
+The containers of the centipedes, their segments and the mushrooms take it as a std::pmr memory resource.
+Blocks come from pools, so a centipede split off another one reuses the node of a centipede shot earlier,
+and the pools are carved out of a monotonic arena that starts in a buffer allocated once with the world.
+Nothing is freed block by block when a new game starts: once the containers are emptied, release() hands the
+whole arena back at once and the next game starts over at the beginning of the buffer.
+The pools are not synchronized, so only one thread at a time may allocate from them.
+*/
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+class LevelMemory
+{
+public:
+    // Bytes of the buffer the arena starts in, enough for the objects of a game
+    static const std::size_t DEFAULT_BUFFER_SIZE = 256 * 1024;
+
+private:
+    // The first buffer of the arena, the arena only falls back on the heap once it is used up
+    std::unique_ptr<std::byte[]> m_Buffer;
+
+    // Hands out memory by bumping a pointer, and frees it all at once
+    std::pmr::monotonic_buffer_resource m_Arena;
+
+    // Recycles the blocks freed during a game, taking new ones from the arena
+    std::pmr::unsynchronized_pool_resource m_Pools;
+
+public:
+    // Constructor that allocates the buffer of the arena.
+    // @param bufferSize The number of bytes of the buffer.
+    explicit LevelMemory(std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    // The containers using the memory refer to it
+    LevelMemory(const LevelMemory&) = delete;
+    LevelMemory& operator=(const LevelMemory&) = delete;
+
+    // @brief Get the memory resource the containers of a game allocate from.
+    // @return The pools, valid as long as the LevelMemory.
+    std::pmr::memory_resource* getResource();
+
+    // @brief Free everything allocated since the last release at once.
+    //        Every container using the memory must be empty and hold no storage.
+    void release();
+};
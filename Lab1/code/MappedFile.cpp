@@ -0,0 +1,132 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the MappedFile class with mmap on POSIX systems and with file mappings on Windows.
+*/
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Unmaps the file.
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// @brief Map a file, unmapping the previous one.
+// @param filename The file.
+// @return False if the file cannot be opened or is empty.
+bool MappedFile::open(const std::string& filename)
+{
+    close();
+
+#ifdef _WIN32
+    m_File = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_File == INVALID_HANDLE_VALUE)
+    {
+        m_File = nullptr;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_File, &size) || size.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = m_Mapping ? MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        close();
+        return false;
+    }
+
+    m_Data = static_cast<const char*>(view);
+    m_Size = static_cast<size_t>(size.QuadPart);
+#else
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    // The mapping stays valid once the descriptor is closed
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_Data = static_cast<const char*>(view);
+    m_Size = static_cast<size_t>(status.st_size);
+#endif
+
+    return true;
+}
+
+// @brief Unmap the file.
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_Data)
+    {
+        UnmapViewOfFile(m_Data);
+    }
+    if (m_Mapping)
+    {
+        CloseHandle(m_Mapping);
+    }
+    if (m_File)
+    {
+        CloseHandle(m_File);
+    }
+    m_Mapping = nullptr;
+    m_File = nullptr;
+#else
+    if (m_Data)
+    {
+        munmap(const_cast<char*>(m_Data), m_Size);
+    }
+#endif
+
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+// @brief Get the first byte of the file.
+// @return The mapped bytes, nullptr when no file is mapped.
+const char* MappedFile::data() const
+{
+    return m_Data;
+}
+
+// @brief Get the size of the file.
+// @return The number of mapped bytes.
+size_t MappedFile::size() const
+{
+    return m_Size;
+}
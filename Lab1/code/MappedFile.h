@@ -0,0 +1,52 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the MappedFile class, a read-only memory mapping of a whole file. The operating
+system pages the file in on demand, so opening a large file is instant and reading a small part of it
+only loads that part.
+*/
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+private:
+    const char* m_Data = nullptr;
+    size_t m_Size = 0;
+
+#ifdef _WIN32
+    // Handles of the file and of its mapping
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+
+    // Unmaps the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // @brief Map a file, unmapping the previous one.
+    // @param filename The file.
+    // @return False if the file cannot be opened or is empty.
+    bool open(const std::string& filename);
+
+    // @brief Unmap the file.
+    void close();
+
+    // @brief Get the first byte of the file.
+    // @return The mapped bytes, nullptr when no file is mapped.
+    const char* data() const;
+
+    // @brief Get the size of the file.
+    // @return The number of mapped bytes.
+    size_t size() const;
+};
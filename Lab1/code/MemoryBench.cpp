@@ -0,0 +1,223 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This is the entry point of the memory benchmark. It plays the allocations of the game objects twice: once on
+the global heap, with the centipedes in a std::list of std::unique_ptr the way the game stored them before, and
+once on a LevelMemory, the way GameWorld stores them, released at once when a game ends.
+The split case shoots long centipedes in random segments until nothing is left of them, so most shots split
+a centipede in two. The reset case fills a game with centipedes and mushrooms, shoots every centipede once and
+starts a new game, over and over. Both runs of a case must shoot the same segments.
+The allocations are only counted when the project is configured with LAB1_COUNT_ALLOCATIONS.
+
+Usage: Lab1MemoryBench [games] [seed]
+*/
+
+#include <iostream>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <SFML/Graphics.hpp>
+
+#include "AllocationCounter.h"
+#include "Assets.h"
+#include "Centipede.h"
+#include "GameWorld.h"
+#include "LevelMemory.h"
+#include "MushroomField.h"
+#include "SegmentArena.h"
+
+using namespace sf;
+
+// Body segments of the centipedes of the split case
+const int splitBodyLength = 200;
+
+// Centipedes and mushrooms of each game of the reset case
+const int resetCentipedes = 16;
+const int resetMushrooms = 300;
+
+// The objects of a game on the global heap, each centipede allocated on its own
+struct HeapGame
+{
+    SegmentArena segments;
+    std::list<std::unique_ptr<Centipede>> centipedes;
+    MushroomField mushrooms{ defaultWindowWidth, defaultWindowHeight };
+
+    void add(const Centipede& centipede) { centipedes.push_back(std::make_unique<Centipede>(centipede)); }
+
+    void release()
+    {
+        centipedes.clear();
+        segments.clear();
+        mushrooms.clear();
+    }
+};
+
+// The objects of a game on a LevelMemory, as in GameWorld
+struct LevelGame
+{
+    LevelMemory memory;
+    SegmentArena segments{ memory.getResource() };
+    std::pmr::list<Centipede> centipedes{ memory.getResource() };
+    MushroomField mushrooms{ defaultWindowWidth, defaultWindowHeight, memory.getResource() };
+
+    void add(const Centipede& centipede) { centipedes.push_back(centipede); }
+
+    void release()
+    {
+        centipedes.clear();
+        segments.clear();
+        mushrooms.clear();
+        memory.release();
+    }
+};
+
+// @brief Get the centipede of an element of either list.
+Centipede& getCentipede(std::unique_ptr<Centipede>& centipede)
+{
+    return *centipede;
+}
+
+Centipede& getCentipede(Centipede& centipede)
+{
+    return centipede;
+}
+
+// @brief Shoot a random segment of every centipede, adding the centipedes split off and removing the empty ones.
+// @param game The game.
+// @param engine The engine choosing the segments.
+// @return The number of centipedes split.
+template <class Game>
+long shootAll(Game& game, std::mt19937& engine)
+{
+    long splits = 0;
+    for (auto it = game.centipedes.begin(); it != game.centipedes.end(); ++it)
+    {
+        Centipede& centipede = getCentipede(*it);
+        int hit = std::uniform_int_distribution<int>(0, centipede.getLength() - 1)(engine);
+        std::optional<Centipede> newCentipede = centipede.handleHit(hit);
+        if (newCentipede)
+        {
+            game.add(*newCentipede);
+            splits++;
+        }
+    }
+
+    game.centipedes.remove_if([](auto& centipede) { return getCentipede(centipede).getLength() < 1; });
+    return splits;
+}
+
+// @brief Shoot long centipedes until nothing is left of them, then start a new game.
+// @param game The game.
+// @param games The number of games.
+// @param seed The seed of the shots.
+// @return The number of centipedes split.
+template <class Game>
+long runSplits(Game& game, int games, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    long splits = 0;
+    for (int i = 0; i < games; i++)
+    {
+        game.add(Centipede(game.segments, splitBodyLength, defaultWindowWidth, headerHeight));
+        while (!game.centipedes.empty())
+        {
+            splits += shootAll(game, engine);
+        }
+        game.release();
+    }
+    return splits;
+}
+
+// @brief Fill games with centipedes and mushrooms, shoot every centipede once and start a new game.
+// @param game The game.
+// @param games The number of games.
+// @param seed The seed of the mushrooms and of the shots.
+// @return The number of centipedes split.
+template <class Game>
+long runResets(Game& game, int games, unsigned seed)
+{
+    std::mt19937 engine(seed);
+    const int cell = MushroomField::CELL_SIZE;
+    std::uniform_int_distribution<int> distrX(1, (defaultWindowWidth - cell) / cell);
+    std::uniform_int_distribution<int> distrY((headerHeight + 2 * cell) / cell, (mushroomFreeHeight - cell) / cell);
+
+    long splits = 0;
+    for (int i = 0; i < games; i++)
+    {
+        for (int j = 0; j < resetCentipedes; j++)
+        {
+            game.add(Centipede(game.segments, GameWorld::NUM_CENTIPEDE_BODY, defaultWindowWidth, headerHeight + j * cell));
+        }
+
+        while (game.mushrooms.size() < resetMushrooms)
+        {
+            game.mushrooms.insert(distrX(engine) * cell, distrY(engine) * cell);
+        }
+
+        splits += shootAll(game, engine);
+        game.release();
+    }
+    return splits;
+}
+
+// @brief Time a case on the global heap and on a LevelMemory.
+// @param name The name of the case.
+// @param heapRun The case on the global heap, called with the game, the number of games and the seed.
+// @param levelRun The same case on a LevelMemory.
+// @param games The number of games.
+// @param seed The seed of the case.
+template <class HeapRun, class LevelRun>
+void runCase(const std::string& name, HeapRun heapRun, LevelRun levelRun, int games, unsigned seed)
+{
+    HeapGame heapGame;
+    long allocations = AllocationCounter::getCount();
+    Clock clock;
+    long heapSplits = heapRun(heapGame, games, seed);
+    Time heapTime = clock.restart();
+    long heapAllocations = AllocationCounter::getCount() - allocations;
+
+    LevelGame levelGame;
+    allocations = AllocationCounter::getCount();
+    clock.restart();
+    long levelSplits = levelRun(levelGame, games, seed);
+    Time levelTime = clock.restart();
+    long levelAllocations = AllocationCounter::getCount() - allocations;
+
+    std::cout << name << ": " << games << " games, " << heapSplits << " splits\n"
+              << "  global heap:  " << heapTime.asMicroseconds() / static_cast<float>(games) << " us/game";
+    if (AllocationCounter::isEnabled())
+    {
+        std::cout << ", " << heapAllocations / static_cast<float>(games) << " allocations/game";
+    }
+    std::cout << "\n  level memory: " << levelTime.asMicroseconds() / static_cast<float>(games) << " us/game";
+    if (AllocationCounter::isEnabled())
+    {
+        std::cout << ", " << levelAllocations / static_cast<float>(games) << " allocations/game";
+    }
+    std::cout << "\n  speedup:      " << heapTime.asSeconds() / levelTime.asSeconds() << "x" << std::endl;
+
+    if (heapSplits != levelSplits)
+    {
+        std::cout << "  error: the runs disagree" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int games = argc > 1 ? std::stoi(argv[1]) : 2000;
+    unsigned seed = argc > 2 ? std::stoul(argv[2]) : 1;
+
+    // No window and no OpenGL context in this process
+    Assets::setHeadless(true);
+    Assets::preload();
+
+    runCase("split", runSplits<HeapGame>, runSplits<LevelGame>, games, seed);
+    runCase("reset", runResets<HeapGame>, runResets<LevelGame>, games, seed);
+
+    return 0;
+}
@@ -0,0 +1,477 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the MushroomField class, a uniform grid index of the mushrooms.
+Every query only visits the occupied cells covered by the query rectangle, found a row at a time in the
+bitmask, so the work it does does not depend on the number of mushrooms in the field; only the cache misses
+of a large field make it slower. Mushrooms are snapped to the lattice, so none reaches past its own cell.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Assets.h"
+#include "BoxKernel.h"
+#include "MushroomField.h"
+
+// Constructor that creates an empty field covering a playfield.
+// @param width The width of the playfield in pixels.
+// @param height The height of the playfield in pixels.
+// @param resource The memory resource the mushrooms are allocated from.
+MushroomField::MushroomField(int width, int height, std::pmr::memory_resource* resource)
+    : m_X(resource), m_Y(resource), m_Life(resource), m_CellOf(resource), m_Sprites(resource)
+{
+    m_Columns = (width + CELL_SIZE - 1) / CELL_SIZE;
+    m_Rows = (height + CELL_SIZE - 1) / CELL_SIZE;
+    m_Cells.assign(m_Columns * m_Rows, EMPTY);
+    m_RowWords = (m_Columns + 63) / 64;
+    m_Occupied.assign(m_RowWords * m_Rows, 0);
+    m_ColumnVersions.assign(m_Columns, 0);
+    m_IsDirty.assign(m_Columns * m_Rows, false);
+}
+
+// @brief Record that a cell must be redrawn.
+// @param cell The index of the cell.
+void MushroomField::markDirty(int cell)
+{
+    // Everything is redrawn anyway
+    if (m_AllDirty || m_IsDirty[cell])
+    {
+        return;
+    }
+
+    m_IsDirty[cell] = true;
+    AllocationCounter::Tag tag(AllocationCounter::Mushrooms);
+    m_DirtyCells.push_back(cell);
+}
+
+// @brief Compute the range of cells covered by a rectangle.
+// @return False if the rectangle is entirely outside of the grid.
+bool MushroomField::getCellRange(const FloatRect& rect, int& firstColumn, int& lastColumn, int& firstRow, int& lastRow) const
+{
+    firstColumn = static_cast<int>(std::floor(rect.left / CELL_SIZE));
+    lastColumn = static_cast<int>(std::floor((rect.left + rect.width) / CELL_SIZE));
+    firstRow = static_cast<int>(std::floor(rect.top / CELL_SIZE));
+    lastRow = static_cast<int>(std::floor((rect.top + rect.height) / CELL_SIZE));
+
+    if (lastColumn < 0 || firstColumn >= m_Columns || lastRow < 0 || firstRow >= m_Rows)
+    {
+        return false;
+    }
+
+    // Clamp to the grid
+    firstColumn = std::max(firstColumn, 0);
+    lastColumn = std::min(lastColumn, m_Columns - 1);
+    firstRow = std::max(firstRow, 0);
+    lastRow = std::min(lastRow, m_Rows - 1);
+    return true;
+}
+
+// @brief Check whether a mushroom intersects a rectangle, reading only its position.
+// @param rect The rectangle to test against.
+// @param index The index of the mushroom.
+// @return True if they overlap, as FloatRect::intersects would tell.
+bool MushroomField::intersects(const FloatRect& rect, int index) const
+{
+    // The rectangle may have a negative size, the mushroom never has
+    float rectLeft = std::min(rect.left, rect.left + rect.width);
+    float rectRight = std::max(rect.left, rect.left + rect.width);
+    float rectTop = std::min(rect.top, rect.top + rect.height);
+    float rectBottom = std::max(rect.top, rect.top + rect.height);
+
+    float x = m_X[index];
+    float y = m_Y[index];
+    return std::max(rectLeft, x) < std::min(rectRight, x + m_Width) && std::max(rectTop, y) < std::min(rectBottom, y + m_Height);
+}
+
+// @brief Find the first mushroom of a row intersecting a rectangle, only visiting the occupied cells.
+// @param rect The rectangle to test against.
+// @param row The row.
+// @param firstColumn The first column to look at.
+// @param lastColumn The last column to look at, included.
+// @return The index of the mushroom in the leftmost such cell, or EMPTY.
+int MushroomField::findInRow(const FloatRect& rect, int row, int firstColumn, int lastColumn) const
+{
+    const std::uint64_t* words = &m_Occupied[row * m_RowWords];
+    for (int word = firstColumn / 64; word <= lastColumn / 64; word++)
+    {
+        // Keep the bits of the columns in range
+        std::uint64_t bits = words[word];
+        int first = std::max(firstColumn - word * 64, 0);
+        int last = std::min(lastColumn - word * 64, 63);
+        bits &= ~std::uint64_t(0) << first;
+        bits &= ~std::uint64_t(0) >> (63 - last);
+
+        while (bits)
+        {
+            int column = word * 64 + BoxKernel::lowestBit(bits);
+            int index = m_Cells[row * m_Columns + column];
+            if (intersects(rect, index))
+            {
+                return index;
+            }
+            bits &= bits - 1;
+        }
+    }
+    return EMPTY;
+}
+
+// @brief Place a mushroom at the top left corner of the cell containing a position.
+// @param x The x-coordinate of the mushroom.
+// @param y The y-coordinate of the mushroom.
+// @return False if the position is outside of the field or the cell already has a mushroom.
+bool MushroomField::insert(float x, float y)
+{
+    int column = static_cast<int>(std::floor(x / CELL_SIZE));
+    int row = static_cast<int>(std::floor(y / CELL_SIZE));
+    if (column < 0 || column >= m_Columns || row < 0 || row >= m_Rows)
+    {
+        return false;
+    }
+
+    // The queries only look at the cells a rectangle covers, a mushroom must not reach past its own cell
+    x = static_cast<float>(column * CELL_SIZE);
+    y = static_cast<float>(row * CELL_SIZE);
+
+    int cell = row * m_Columns + column;
+    if (m_Cells[cell] != EMPTY)
+    {
+        return false;
+    }
+
+    AllocationCounter::Tag tag(AllocationCounter::Mushrooms);
+    m_Cells[cell] = size();
+    m_Occupied[row * m_RowWords + column / 64] |= std::uint64_t(1) << (column % 64);
+    m_X.push_back(x);
+    m_Y.push_back(y);
+    m_Life.push_back(MAX_LIFE);
+    m_CellOf.push_back(cell);
+
+    // The textures are shared by all mushrooms
+    m_Sprites.emplace_back();
+    Sprite& sprite = m_Sprites.back();
+    Assets::setSprite(sprite, "graphics/Mushroom0.png");
+    sprite.setPosition(x, y);
+    m_Width = sprite.getLocalBounds().width;
+    m_Height = sprite.getLocalBounds().height;
+
+    m_ColumnVersions[column]++;
+    markDirty(cell);
+    return true;
+}
+
+// @brief Remove a mushroom of the field by moving the last mushroom into its slot.
+// @param index The index of the mushroom.
+void MushroomField::erase(int index)
+{
+    int last = size() - 1;
+    int cell = m_CellOf[index];
+    int column = cell % m_Columns;
+    m_Cells[cell] = EMPTY;
+    m_Occupied[cell / m_Columns * m_RowWords + column / 64] &= ~(std::uint64_t(1) << (column % 64));
+    m_ColumnVersions[column]++;
+    markDirty(cell);
+
+    if (index != last)
+    {
+        m_X[index] = m_X[last];
+        m_Y[index] = m_Y[last];
+        m_Life[index] = m_Life[last];
+        m_CellOf[index] = m_CellOf[last];
+        m_Sprites[index] = m_Sprites[last];
+        m_Cells[m_CellOf[index]] = index;
+    }
+
+    m_X.pop_back();
+    m_Y.pop_back();
+    m_Life.pop_back();
+    m_CellOf.pop_back();
+    m_Sprites.pop_back();
+}
+
+// @brief Reduce the life of a mushroom of the field, changing its image.
+// @param index The index of the mushroom.
+void MushroomField::reduceLife(int index)
+{
+    // Change to the damaged image of the atlas if the mushroom is at full life and is hit
+    if (m_Life[index] == MAX_LIFE)
+    {
+        m_Sprites[index].setTextureRect(Assets::getTextureRect("graphics/Mushroom1.png"));
+    }
+
+    m_Life[index]--;
+    markDirty(m_CellOf[index]);
+}
+
+// @brief Remove every mushroom intersecting a rectangle.
+// @param rect The rectangle to test against.
+// @return The number of removed mushrooms.
+int MushroomField::eraseIntersecting(const FloatRect& rect)
+{
+    int firstColumn, lastColumn, firstRow, lastRow;
+    if (!getCellRange(rect, firstColumn, lastColumn, firstRow, lastRow))
+    {
+        return 0;
+    }
+
+    // Erasing a mushroom only empties its own cell, the search goes on from the next column
+    int erased = 0;
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        int column = firstColumn;
+        int index;
+        while (column <= lastColumn && (index = findInRow(rect, row, column, lastColumn)) != EMPTY)
+        {
+            column = m_CellOf[index] % m_Columns + 1;
+            erase(index);
+            erased++;
+        }
+    }
+    return erased;
+}
+
+// @brief Find a mushroom intersecting a rectangle.
+// @param rect The rectangle to test against.
+// @return The index of the first intersecting mushroom in row-major cell order, or EMPTY if there is none.
+int MushroomField::findIntersecting(const FloatRect& rect) const
+{
+    int firstColumn, lastColumn, firstRow, lastRow;
+    if (!getCellRange(rect, firstColumn, lastColumn, firstRow, lastRow))
+    {
+        return EMPTY;
+    }
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        int index = findInRow(rect, row, firstColumn, lastColumn);
+        if (index != EMPTY)
+        {
+            return index;
+        }
+    }
+    return EMPTY;
+}
+
+// @brief Find the first mushroom in the way of a rectangle moving straight up.
+//        The columns covered by the rectangle are scanned upward from its bottom row, so the first
+//        mushroom found is the one whose bottom edge the rectangle reaches first.
+// @param rect The rectangle at its current position.
+// @param column Set to the column of the mushroom.
+// @param row Set to the row of the mushroom.
+// @return False if no mushroom is in the way.
+bool MushroomField::findFirstAbove(const FloatRect& rect, int& column, int& row) const
+{
+    // Everything above the bottom of the rectangle is in the way
+    FloatRect path(rect.left, -1.f, rect.width, rect.top + rect.height + 1.f);
+
+    int firstColumn, lastColumn, firstRow, lastRow;
+    if (!getCellRange(path, firstColumn, lastColumn, firstRow, lastRow))
+    {
+        return false;
+    }
+
+    for (row = lastRow; row >= firstRow; row--)
+    {
+        int index = findInRow(path, row, firstColumn, lastColumn);
+        if (index != EMPTY)
+        {
+            column = m_CellOf[index] % m_Columns;
+            return true;
+        }
+    }
+    return false;
+}
+
+// @brief Get a number that changes whenever a mushroom is added to or removed from the columns covered by a rectangle.
+// @param rect The rectangle.
+// @return The sum of the versions of the covered columns.
+unsigned MushroomField::getColumnsVersion(const FloatRect& rect) const
+{
+    int firstColumn = std::max(static_cast<int>(std::floor(rect.left / CELL_SIZE)), 0);
+    int lastColumn = std::min(static_cast<int>(std::floor((rect.left + rect.width) / CELL_SIZE)), m_Columns - 1);
+
+    unsigned version = 0;
+    for (int column = firstColumn; column <= lastColumn; column++)
+    {
+        version += m_ColumnVersions[column];
+    }
+    return version;
+}
+
+// @brief Get the mushroom of a cell.
+// @param column The column of the cell.
+// @param row The row of the cell.
+// @return The index of the mushroom in the cell, or EMPTY if the cell is empty or outside of the field.
+int MushroomField::getAt(int column, int row) const
+{
+    if (column < 0 || column >= m_Columns || row < 0 || row >= m_Rows)
+    {
+        return EMPTY;
+    }
+
+    return m_Cells[row * m_Columns + column];
+}
+
+// @brief Get the global bounding box of a mushroom for collision detection.
+// @param index The index of the mushroom.
+FloatRect MushroomField::getBounds(int index) const
+{
+    return FloatRect(m_X[index], m_Y[index], m_Width, m_Height);
+}
+
+// @brief Get the position of a mushroom, the top left corner of its sprite.
+// @param index The index of the mushroom.
+Vector2f MushroomField::getPosition(int index) const
+{
+    return Vector2f(m_X[index], m_Y[index]);
+}
+
+// @brief Get the remaining life of a mushroom.
+// @param index The index of the mushroom.
+int MushroomField::getLife(int index) const
+{
+    return m_Life[index];
+}
+
+// @brief Get the sprite of a mushroom for rendering.
+// @param index The index of the mushroom.
+const Sprite& MushroomField::getSprite(int index) const
+{
+    return m_Sprites[index];
+}
+
+// @brief Remove all the mushrooms and give their storage back to the memory resource.
+void MushroomField::clear()
+{
+    std::pmr::vector<float>(m_X.get_allocator()).swap(m_X);
+    std::pmr::vector<float>(m_Y.get_allocator()).swap(m_Y);
+    std::pmr::vector<signed char>(m_Life.get_allocator()).swap(m_Life);
+    std::pmr::vector<int>(m_CellOf.get_allocator()).swap(m_CellOf);
+    std::pmr::vector<Sprite>(m_Sprites.get_allocator()).swap(m_Sprites);
+    std::fill(m_Cells.begin(), m_Cells.end(), EMPTY);
+    std::fill(m_Occupied.begin(), m_Occupied.end(), 0);
+    for (unsigned& version : m_ColumnVersions)
+    {
+        version++;
+    }
+    clearDirty();
+    m_AllDirty = true;
+}
+
+// @brief Save the mushrooms, in their storage order, and the versions of the columns.
+//        Storing them in the same order makes a restored field visit its mushrooms in the same order.
+// @param writer The state being written.
+void MushroomField::saveState(StateWriter& writer) const
+{
+    writer.write(size());
+    for (int i = 0; i < size(); i++)
+    {
+        writer.write(getPosition(i));
+        writer.write(getLife(i));
+    }
+
+    for (unsigned version : m_ColumnVersions)
+    {
+        writer.write(version);
+    }
+}
+
+// @brief Replace the mushrooms with the ones written by saveState. Every cell becomes dirty.
+// @param reader The state being read.
+void MushroomField::loadState(StateReader& reader)
+{
+    clear();
+
+    int count = 0;
+    reader.read(count);
+    for (int i = 0; i < count && reader.isValid(); i++)
+    {
+        Vector2f position;
+        int life = MAX_LIFE;
+        reader.read(position);
+        reader.read(life);
+
+        // A corrupt keyframe may hold any life, or a position off the lattice
+        if (life < 1 || life > MAX_LIFE || !insert(position.x, position.y) || getPosition(size() - 1) != position)
+        {
+            reader.fail();
+            return;
+        }
+
+        // A new mushroom has MAX_LIFE, a hit takes one
+        for (int hit = life; hit < MAX_LIFE; hit++)
+        {
+            reduceLife(size() - 1);
+        }
+    }
+
+    // Lasers compare the versions to know whether their target is still valid
+    for (unsigned& version : m_ColumnVersions)
+    {
+        reader.read(version);
+    }
+}
+
+// @brief Check whether the whole field changed since the last clearDirty().
+// @return True if every cell must be redrawn.
+bool MushroomField::isAllDirty() const
+{
+    return m_AllDirty;
+}
+
+// @brief Get the cells whose mushroom was added, removed or damaged since the last clearDirty().
+// @return The indices of the cells.
+const std::vector<int>& MushroomField::getDirtyCells() const
+{
+    return m_DirtyCells;
+}
+
+// @brief Forget the changes, once they are redrawn.
+void MushroomField::clearDirty()
+{
+    for (int cell : m_DirtyCells)
+    {
+        m_IsDirty[cell] = false;
+    }
+    m_DirtyCells.clear();
+    m_AllDirty = false;
+}
+
+// @brief Get the number of mushrooms.
+int MushroomField::size() const
+{
+    return static_cast<int>(m_X.size());
+}
+
+// @brief Check whether the field has no mushroom.
+bool MushroomField::empty() const
+{
+    return m_X.empty();
+}
+
+// @brief Get the number of columns of the grid.
+int MushroomField::getColumns() const
+{
+    return m_Columns;
+}
+
+// @brief Get the number of rows of the grid.
+int MushroomField::getRows() const
+{
+    return m_Rows;
+}
+
+std::pmr::vector<Sprite>::const_iterator MushroomField::begin() const
+{
+    return m_Sprites.begin();
+}
+
+std::pmr::vector<Sprite>::const_iterator MushroomField::end() const
+{
+    return m_Sprites.end();
+}
@@ -0,0 +1,207 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the MushroomField class, which stores the mushrooms of the playfield in a uniform grid.
+Mushrooms sit on a lattice of CELL_SIZE pixel cells, at most one per cell, so a collision query only has to look
+at the few cells covered by the querying object instead of scanning every mushroom.
+The mushrooms are stored as a structure of arrays: the collision queries only read the packed positions and
+lives, and a bitmask of the occupied cells lets them skip the empty cells a row at a time. The sprites, only
+needed for rendering, are kept in an array of their own. All the mushrooms have the size of the same image.
+A mushroom is identified by its index in the arrays; the arrays stay contiguous and are kept packed with
+swap-and-pop, so an index is only valid until the next mushroom is removed.
+Each column of the grid keeps a version number that changes whenever a mushroom of the column is added or
+removed, so objects that cached a query on a column know when to repeat it. In the same way the cells whose
+look changed are recorded until the renderer redraws them.
+The mushrooms are allocated from a memory resource, the LevelMemory of the world in the game; the grid is
+allocated once with the field.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "StateStream.h"
+
+using namespace sf;
+
+class MushroomField
+{
+public:
+    // Size of a grid cell in pixels, mushrooms are placed on multiples of it
+    static constexpr int CELL_SIZE = 30;
+
+    // Marks a cell without mushroom, and a query that found none
+    static constexpr int EMPTY = -1;
+
+    // Life of a new mushroom, it is destroyed once the life reaches 0
+    static const int MAX_LIFE = 2;
+
+private:
+    // Size of the grid
+    int m_Columns;
+    int m_Rows;
+
+    // Size of every mushroom, set by the first insert
+    float m_Width = 0.f;
+    float m_Height = 0.f;
+
+    // The mushrooms, contiguous and in no particular order: position, life and cell
+    std::pmr::vector<float> m_X;
+    std::pmr::vector<float> m_Y;
+    std::pmr::vector<signed char> m_Life;
+    std::pmr::vector<int> m_CellOf;
+
+    // The sprite of each mushroom, parallel to the arrays above and only read for rendering
+    std::pmr::vector<Sprite> m_Sprites;
+
+    // Index of the mushroom in each cell, or EMPTY
+    std::vector<int> m_Cells;
+
+    // One bit per cell set when the cell has a mushroom, each row starting on a new word
+    std::vector<std::uint64_t> m_Occupied;
+    int m_RowWords;
+
+    // Version of each column, incremented when a mushroom of the column is added or removed
+    std::vector<unsigned> m_ColumnVersions;
+
+    // Cells that changed since the last clearDirty(), each listed once, unless the whole field changed
+    std::vector<int> m_DirtyCells;
+    std::vector<bool> m_IsDirty;
+    bool m_AllDirty = true;
+
+    // @brief Record that a cell must be redrawn.
+    // @param cell The index of the cell.
+    void markDirty(int cell);
+
+    // @brief Compute the range of cells covered by a rectangle.
+    // @param rect The rectangle in pixels.
+    // @param firstColumn, lastColumn, firstRow, lastRow Set to the inclusive range of covered cells.
+    // @return False if the rectangle is entirely outside of the grid.
+    bool getCellRange(const FloatRect& rect, int& firstColumn, int& lastColumn, int& firstRow, int& lastRow) const;
+
+    // @brief Find the first mushroom of a row intersecting a rectangle, only visiting the occupied cells.
+    // @param rect The rectangle to test against.
+    // @param row The row.
+    // @param firstColumn The first column to look at.
+    // @param lastColumn The last column to look at, included.
+    // @return The index of the mushroom in the leftmost such cell, or EMPTY.
+    int findInRow(const FloatRect& rect, int row, int firstColumn, int lastColumn) const;
+
+    // @brief Check whether a mushroom intersects a rectangle, reading only its position.
+    // @param rect The rectangle to test against.
+    // @param index The index of the mushroom.
+    // @return True if they overlap, as FloatRect::intersects would tell.
+    bool intersects(const FloatRect& rect, int index) const;
+
+public:
+    // Constructor that creates an empty field covering a playfield.
+    // @param width The width of the playfield in pixels.
+    // @param height The height of the playfield in pixels.
+    // @param resource The memory resource the mushrooms are allocated from, it must outlive the field.
+    MushroomField(int width, int height, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // @brief Place a mushroom at the top left corner of the cell containing a position.
+    // @param x The x-coordinate of the mushroom.
+    // @param y The y-coordinate of the mushroom.
+    // @return False if the position is outside of the field or the cell already has a mushroom.
+    bool insert(float x, float y);
+
+    // @brief Remove a mushroom of the field. The last mushroom takes its index.
+    // @param index The index of the mushroom.
+    void erase(int index);
+
+    // @brief Reduce the life of a mushroom of the field, changing its image.
+    // @param index The index of the mushroom.
+    void reduceLife(int index);
+
+    // @brief Remove every mushroom intersecting a rectangle.
+    // @param rect The rectangle to test against.
+    // @return The number of removed mushrooms.
+    int eraseIntersecting(const FloatRect& rect);
+
+    // @brief Find a mushroom intersecting a rectangle.
+    // @param rect The rectangle to test against.
+    // @return The index of the first intersecting mushroom in row-major cell order, or EMPTY if there is none.
+    int findIntersecting(const FloatRect& rect) const;
+
+    // @brief Find the first mushroom in the way of a rectangle moving straight up.
+    // @param rect The rectangle at its current position.
+    // @param column Set to the column of the mushroom.
+    // @param row Set to the row of the mushroom.
+    // @return False if no mushroom is in the way.
+    bool findFirstAbove(const FloatRect& rect, int& column, int& row) const;
+
+    // @brief Get a number that changes whenever a mushroom is added to or removed from the columns covered by a rectangle.
+    // @param rect The rectangle.
+    // @return The sum of the versions of the covered columns.
+    unsigned getColumnsVersion(const FloatRect& rect) const;
+
+    // @brief Get the mushroom of a cell.
+    // @param column The column of the cell.
+    // @param row The row of the cell.
+    // @return The index of the mushroom in the cell, or EMPTY if the cell is empty or outside of the field.
+    int getAt(int column, int row) const;
+
+    // @brief Get the global bounding box of a mushroom for collision detection.
+    // @param index The index of the mushroom.
+    FloatRect getBounds(int index) const;
+
+    // @brief Get the position of a mushroom, the top left corner of its sprite.
+    // @param index The index of the mushroom.
+    Vector2f getPosition(int index) const;
+
+    // @brief Get the remaining life of a mushroom.
+    // @param index The index of the mushroom.
+    int getLife(int index) const;
+
+    // @brief Get the sprite of a mushroom for rendering.
+    // @param index The index of the mushroom.
+    const Sprite& getSprite(int index) const;
+
+    // @brief Remove all the mushrooms and give their storage back to the memory resource.
+    void clear();
+
+    // @brief Check whether the whole field changed since the last clearDirty(), e.g. for a new game.
+    // @return True if every cell must be redrawn.
+    bool isAllDirty() const;
+
+    // @brief Get the cells whose mushroom was added, removed or damaged since the last clearDirty().
+    // @return The indices of the cells (row * columns + column), meaningless when isAllDirty() is true.
+    const std::vector<int>& getDirtyCells() const;
+
+    // @brief Forget the changes, once they are redrawn.
+    void clearDirty();
+
+    // @brief Get the number of mushrooms.
+    // @return The number of mushrooms in the field.
+    int size() const;
+
+    // @brief Check whether the field has no mushroom.
+    // @return True if the field is empty.
+    bool empty() const;
+
+    // @brief Get the number of columns of the grid.
+    // @return The number of columns.
+    int getColumns() const;
+
+    // @brief Get the number of rows of the grid.
+    // @return The number of rows.
+    int getRows() const;
+
+    // @brief Save the mushrooms, in their storage order, and the versions of the columns.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Replace the mushrooms with the ones written by saveState. Every cell becomes dirty.
+    // @param reader The state being read.
+    void loadState(StateReader& reader);
+
+    // Iteration over the sprites of all the mushrooms, in index order, used for rendering
+    std::pmr::vector<Sprite>::const_iterator begin() const;
+    std::pmr::vector<Sprite>::const_iterator end() const;
+};
@@ -0,0 +1,338 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the hardware performance counters with perf_event_open and the PerfReport class.
+The four counters of a thread form one group led by the cycles, so a single read() returns all of them
+measured over the same interval.
+*/
+
+#include <iomanip>
+#include <mutex>
+
+#include "PerfCounters.h"
+#include "TaskGraph.h"
+
+#if defined(LAB1_PERF_COUNTERS) && defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LAB1_HAS_PERF_EVENTS
+#endif
+
+namespace
+{
+    std::mutex s_ErrorMutex;
+    std::string s_Error;
+    int s_Available = 0;
+
+#ifdef LAB1_HAS_PERF_EVENTS
+    bool s_AnyOpened = false;
+
+    // @brief Combine the counters a thread opened with the other threads', only the ones every thread has
+    //        are reported.
+    // @param available The bits of the counters the thread opened, 0 if it opened none.
+    void addAvailable(int available)
+    {
+        std::lock_guard<std::mutex> lock(s_ErrorMutex);
+        s_Available = s_AnyOpened ? s_Available & available : available;
+        s_AnyOpened = true;
+    }
+
+    // @brief Keep the first reason the counters could not be opened.
+    void setError(const std::string& error)
+    {
+        std::lock_guard<std::mutex> lock(s_ErrorMutex);
+        if (s_Error.empty())
+        {
+            s_Error = error;
+        }
+    }
+
+    // The counters of the group, the first one leads it
+    const std::uint64_t counterConfigs[] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    const int counterCount = 4;
+
+    // The group of a thread, closed when the thread exits
+    struct ThreadCounters
+    {
+        bool opened = false;
+        int fds[counterCount] = { -1, -1, -1, -1 };
+
+        // Which counter each value of a group read belongs to
+        int order[counterCount];
+        int count = 0;
+
+        ~ThreadCounters()
+        {
+            for (int fd : fds)
+            {
+                if (fd >= 0)
+                {
+                    close(fd);
+                }
+            }
+        }
+
+        // @brief Open the group, a missing counter other than the cycles is left out.
+        void open()
+        {
+            opened = true;
+            for (int i = 0; i < counterCount; i++)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = counterConfigs[i];
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                // This thread, on any CPU
+                int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+                if (fd < 0)
+                {
+                    if (i == 0)
+                    {
+                        setError(std::string("perf_event_open: ") + std::strerror(errno));
+                        addAvailable(0);
+                        return;
+                    }
+                    continue;
+                }
+
+                fds[i] = fd;
+                order[count++] = i;
+            }
+
+            int available = 0;
+            for (int i = 0; i < count; i++)
+            {
+                available |= 1 << order[i];
+            }
+            addAvailable(available);
+        }
+    };
+
+    thread_local ThreadCounters t_Counters;
+#endif
+}
+
+PerfCounters::Values& PerfCounters::Values::operator+=(const Values& other)
+{
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    return *this;
+}
+
+PerfCounters::Values PerfCounters::Values::operator-(const Values& other) const
+{
+    Values difference;
+    difference.cycles = cycles - other.cycles;
+    difference.instructions = instructions - other.instructions;
+    difference.cacheMisses = cacheMisses - other.cacheMisses;
+    difference.branchMisses = branchMisses - other.branchMisses;
+    return difference;
+}
+
+// @brief Check whether the counters are compiled in.
+// @return True when built with LAB1_PERF_COUNTERS.
+bool PerfCounters::isEnabled()
+{
+#ifdef LAB1_PERF_COUNTERS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// @brief Read the counters of the calling thread, opening them the first time.
+// @param values Set to the counts since the counters were opened, scaled when the kernel multiplexed them.
+// @return False if the counters are unavailable on this thread.
+bool PerfCounters::read(Values& values)
+{
+#ifdef LAB1_HAS_PERF_EVENTS
+    ThreadCounters& counters = t_Counters;
+    if (!counters.opened)
+    {
+        counters.open();
+    }
+    if (counters.fds[0] < 0)
+    {
+        return false;
+    }
+
+    // Number of values, time enabled, time running, then the values
+    std::uint64_t data[3 + counterCount];
+    ssize_t size = ::read(counters.fds[0], data, sizeof(data));
+    if (size < static_cast<ssize_t>(sizeof(std::uint64_t) * (3 + counters.count)))
+    {
+        return false;
+    }
+
+    std::uint64_t counts[counterCount] = {};
+    for (int i = 0; i < counters.count; i++)
+    {
+        std::uint64_t count = data[3 + i];
+        if (data[2] > 0 && data[2] < data[1])
+        {
+            count = static_cast<std::uint64_t>(static_cast<double>(count) * data[1] / data[2]);
+        }
+        counts[counters.order[i]] = count;
+    }
+
+    values.cycles = counts[0];
+    values.instructions = counts[1];
+    values.cacheMisses = counts[2];
+    values.branchMisses = counts[3];
+    return true;
+#else
+    (void)values;
+    return false;
+#endif
+}
+
+// @brief Get the counters provided on every thread that read them so far.
+// @return The bits of the Counter values that are counted, 0 if none.
+int PerfCounters::getAvailable()
+{
+    std::lock_guard<std::mutex> lock(s_ErrorMutex);
+    return s_Available;
+}
+
+// @brief Get why the counters are unavailable.
+// @return The error of the first thread that failed to open them, empty if none failed.
+std::string PerfCounters::getError()
+{
+#ifndef LAB1_PERF_COUNTERS
+    return "the counters are compiled out, configure with LAB1_PERF_COUNTERS";
+#elif !defined(LAB1_HAS_PERF_EVENTS)
+    return "perf_event_open is only available on Linux";
+#else
+    std::lock_guard<std::mutex> lock(s_ErrorMutex);
+    return s_Error;
+#endif
+}
+
+// @brief Write the counters of every step as a CSV line, one column per task and counter.
+// @param out The stream, nullptr to only aggregate; it must outlive the report.
+void PerfReport::setTickStream(std::ostream* out)
+{
+    m_Ticks = out;
+}
+
+// @brief Add the counters of the last run of a graph, once per run.
+// @param graph The step graph, with its counters read around each task.
+void PerfReport::add(const TaskGraph& graph)
+{
+    // Paused steps do not run the graph
+    if (graph.getRuns() == m_GraphRuns || !PerfCounters::getAvailable())
+    {
+        return;
+    }
+    m_GraphRuns = graph.getRuns();
+
+    if (m_Names.empty())
+    {
+        for (int i = 0; i < graph.size(); i++)
+        {
+            m_Names.push_back(graph.getName(i));
+        }
+        m_Totals.resize(m_Names.size());
+
+        if (m_Ticks)
+        {
+            *m_Ticks << "step";
+            for (const std::string& name : m_Names)
+            {
+                *m_Ticks << "," << name << " cycles," << name << " instructions," << name << " cache misses,"
+                         << name << " branch misses";
+            }
+            *m_Ticks << "\n";
+        }
+    }
+
+    if (m_Ticks)
+    {
+        *m_Ticks << m_Steps;
+    }
+
+    for (size_t i = 0; i < m_Totals.size(); i++)
+    {
+        PerfCounters::Values values = graph.getCounters(static_cast<int>(i));
+        m_Totals[i] += values;
+        if (m_Ticks)
+        {
+            *m_Ticks << "," << values.cycles << "," << values.instructions << "," << values.cacheMisses
+                     << "," << values.branchMisses;
+        }
+    }
+
+    if (m_Ticks)
+    {
+        *m_Ticks << "\n";
+    }
+    m_Steps++;
+}
+
+// @brief Write the totals of each task with the instructions per cycle and the misses per 1000 instructions,
+//        or why the counters are unavailable.
+// @param out The stream to write to.
+void PerfReport::writeReport(std::ostream& out) const
+{
+    int available = PerfCounters::getAvailable();
+    if (!available)
+    {
+        std::string error = PerfCounters::getError();
+        out << "hardware counters unavailable" << (error.empty() ? "" : ": " + error) << "\n";
+        return;
+    }
+
+    std::ios::fmtflags flags = out.flags();
+    out << "hardware counters over " << m_Steps << " steps, per step:\n";
+    out << std::left << std::setw(24) << "task" << std::right << std::setw(12) << "cycles" << std::setw(14)
+        << "instructions" << std::setw(8) << "IPC" << std::setw(14) << "cache MPKI" << std::setw(14)
+        << "branch MPKI" << "\n";
+
+    out << std::fixed;
+    for (size_t i = 0; i < m_Totals.size(); i++)
+    {
+        const PerfCounters::Values& total = m_Totals[i];
+        double steps = static_cast<double>(m_Steps > 0 ? m_Steps : 1);
+        double kiloInstructions = total.instructions / 1000.;
+
+        out << std::left << std::setw(24) << m_Names[i] << std::right << std::setprecision(0)
+            << std::setw(12) << total.cycles / steps << std::setw(14) << total.instructions / steps
+            << std::setprecision(2) << std::setw(8) << (total.cycles ? static_cast<double>(total.instructions) / total.cycles : 0);
+
+        // Misses per 1000 instructions, n/a for the counters the hardware lacks
+        if (available & PerfCounters::CacheMisses)
+        {
+            out << std::setw(14) << (kiloInstructions > 0 ? total.cacheMisses / kiloInstructions : 0);
+        }
+        else
+        {
+            out << std::setw(14) << "n/a";
+        }
+
+        if (available & PerfCounters::BranchMisses)
+        {
+            out << std::setw(14) << (kiloInstructions > 0 ? total.branchMisses / kiloInstructions : 0);
+        }
+        else
+        {
+            out << std::setw(14) << "n/a";
+        }
+        out << "\n";
+    }
+    out.flags(flags);
+}
@@ -0,0 +1,88 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file declares the hardware performance counters and the PerfReport class. When the project is
+configured with LAB1_PERF_COUNTERS on Linux, every thread that reads the counters opens a perf_event_open
+group counting its own cycles, instructions, cache misses and branch misses in user space, and the step graph
+reads them around each of its tasks. The counters may be unavailable: without the option, on other systems,
+when perf_event_paranoid forbids them, or in a virtual machine without a PMU. Reading them then fails and the
+reports say why, the game runs as usual.
+*/
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class TaskGraph;
+
+namespace PerfCounters
+{
+    // The counters of a thread, or the difference between two readings
+    struct Values
+    {
+        std::uint64_t cycles = 0;
+        std::uint64_t instructions = 0;
+        std::uint64_t cacheMisses = 0;
+        std::uint64_t branchMisses = 0;
+
+        Values& operator+=(const Values& other);
+        Values operator-(const Values& other) const;
+    };
+
+    // Bits of the counters the hardware provides
+    enum Counter
+    {
+        Cycles = 1 << 0,
+        Instructions = 1 << 1,
+        CacheMisses = 1 << 2,
+        BranchMisses = 1 << 3
+    };
+
+    // @brief Check whether the counters are compiled in.
+    // @return True when built with LAB1_PERF_COUNTERS.
+    bool isEnabled();
+
+    // @brief Read the counters of the calling thread, opening them the first time.
+    // @param values Set to the counts since the counters were opened, scaled when the kernel multiplexed them.
+    // @return False if the counters are unavailable on this thread.
+    bool read(Values& values);
+
+    // @brief Get the counters provided on every thread that read them so far.
+    // @return The bits of the Counter values that are counted, 0 if none.
+    int getAvailable();
+
+    // @brief Get why the counters are unavailable.
+    // @return The error of the first thread that failed to open them, empty if none failed.
+    std::string getError();
+}
+
+class PerfReport
+{
+private:
+    // Sums over the steps, per task of the graph
+    std::vector<std::string> m_Names;
+    std::vector<PerfCounters::Values> m_Totals;
+    std::uint64_t m_Steps = 0;
+    std::uint64_t m_GraphRuns = 0;
+
+    std::ostream* m_Ticks = nullptr;
+
+public:
+    // @brief Write the counters of every step as a CSV line, one column per task and counter.
+    // @param out The stream, nullptr to only aggregate; it must outlive the report.
+    void setTickStream(std::ostream* out);
+
+    // @brief Add the counters of the last run of a graph, once per run.
+    // @param graph The step graph, with its counters read around each task.
+    void add(const TaskGraph& graph);
+
+    // @brief Write the totals of each task with the instructions per cycle and the misses per 1000 instructions,
+    //        or why the counters are unavailable.
+    // @param out The stream to write to.
+    void writeReport(std::ostream& out) const;
+};
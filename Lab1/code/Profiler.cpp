@@ -0,0 +1,341 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the frame profiler. Each thread owns the histograms and events it records, so a scope
+never takes a lock; the lists of threads and names are only locked the first time a thread or name shows up.
+The histograms have 16 buckets per power of two, so a reported percentile is within about 6% of the exact one.
+*/
+
+#include <mutex>
+#include <set>
+
+#include "Profiler.h"
+
+namespace
+{
+    std::mutex s_NameMutex;
+    std::set<std::string> s_Names;
+}
+
+// @brief Get a copy of a name that lives as long as the process, for scopes named at run time.
+// @param name The name.
+// @return The same pointer for equal names.
+const char* Profiler::intern(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(s_NameMutex);
+    return s_Names.insert(name).first->c_str();
+}
+
+#ifdef LAB1_PROFILE
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Durations below 16 ns have a bucket each, then every power of two has 16 buckets
+    const int subBucketBits = 4;
+    const int subBuckets = 1 << subBucketBits;
+    const int bucketCount = 61 * subBuckets;
+
+    // Events kept per thread, later scopes only go to the histograms
+    const size_t maxEvents = 1 << 19;
+
+    struct Histogram
+    {
+        const char* name = nullptr;
+        std::uint64_t count = 0;
+        std::int64_t total = 0;
+        std::int64_t max = 0;
+        std::vector<std::uint32_t> buckets = std::vector<std::uint32_t>(bucketCount);
+    };
+
+    struct Event
+    {
+        const char* name;
+        std::int64_t start;
+        std::int64_t duration;
+    };
+
+    struct ThreadData
+    {
+        int id = 0;
+        std::string name;
+        std::vector<Histogram> histograms;
+        std::vector<Event> events;
+        std::uint64_t droppedEvents = 0;
+    };
+
+    // Every thread that recorded a scope, kept after the thread exits
+    std::mutex s_ThreadMutex;
+    std::vector<std::unique_ptr<ThreadData>> s_Threads;
+    thread_local ThreadData* t_Data = nullptr;
+
+    const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+    // @brief Get the time since the process started.
+    // @return The time in nanoseconds.
+    std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+    }
+
+    // @brief Get the data of the calling thread, registering the thread the first time.
+    ThreadData& getThreadData()
+    {
+        if (!t_Data)
+        {
+            std::lock_guard<std::mutex> lock(s_ThreadMutex);
+            s_Threads.push_back(std::make_unique<ThreadData>());
+            t_Data = s_Threads.back().get();
+            t_Data->id = static_cast<int>(s_Threads.size());
+            t_Data->name = "thread " + std::to_string(t_Data->id);
+        }
+        return *t_Data;
+    }
+
+    // @brief Get the bucket of a duration.
+    int getBucket(std::int64_t duration)
+    {
+        std::uint64_t value = static_cast<std::uint64_t>(std::max<std::int64_t>(duration, 0));
+        if (value < static_cast<std::uint64_t>(subBuckets))
+        {
+            return static_cast<int>(value);
+        }
+
+        int exponent = 63;
+        while (!(value >> exponent))
+        {
+            exponent--;
+        }
+        int sub = static_cast<int>((value >> (exponent - subBucketBits)) & (subBuckets - 1));
+        return (exponent - subBucketBits + 1) * subBuckets + sub;
+    }
+
+    // @brief Get the middle of the durations falling in a bucket.
+    double getBucketValue(int bucket)
+    {
+        if (bucket < subBuckets)
+        {
+            return bucket;
+        }
+
+        int shift = bucket / subBuckets - 1;
+        double low = static_cast<double>(static_cast<std::uint64_t>(subBuckets + bucket % subBuckets) << shift);
+        return low + static_cast<double>(std::uint64_t(1) << shift) / 2;
+    }
+
+    // @brief Get a percentile of the durations in a histogram.
+    // @param fraction The fraction of the durations at or below the result.
+    // @return The duration in nanoseconds.
+    double getPercentile(const Histogram& histogram, double fraction)
+    {
+        std::uint64_t target = std::max<std::uint64_t>(static_cast<std::uint64_t>(fraction * histogram.count + .5), 1);
+        std::uint64_t seen = 0;
+        for (int i = 0; i < bucketCount; i++)
+        {
+            seen += histogram.buckets[i];
+            if (seen >= target)
+            {
+                return std::min(getBucketValue(i), static_cast<double>(histogram.max));
+            }
+        }
+        return static_cast<double>(histogram.max);
+    }
+
+    // @brief Write a string as a JSON string.
+    void writeJsonString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+}
+
+// Starts timing.
+Profiler::Scope::Scope(const char* name) : m_Name(name), m_Start(now())
+{
+}
+
+// Records the scope.
+Profiler::Scope::~Scope()
+{
+    std::int64_t duration = now() - m_Start;
+    ThreadData& data = getThreadData();
+
+    if (data.events.size() < maxEvents)
+    {
+        data.events.push_back(Event{ m_Name, m_Start, duration });
+    }
+    else
+    {
+        data.droppedEvents++;
+    }
+
+    // A thread only runs a handful of different scopes
+    auto histogram = std::find_if(data.histograms.begin(), data.histograms.end(),
+        [this](const Histogram& h) { return h.name == m_Name; });
+    if (histogram == data.histograms.end())
+    {
+        data.histograms.emplace_back();
+        histogram = data.histograms.end() - 1;
+        histogram->name = m_Name;
+    }
+
+    histogram->count++;
+    histogram->total += duration;
+    histogram->max = std::max(histogram->max, duration);
+    histogram->buckets[getBucket(duration)]++;
+}
+
+// @brief Check whether scopes are being recorded in this build.
+// @return True when built with LAB1_PROFILE.
+bool Profiler::isEnabled()
+{
+    return true;
+}
+
+// @brief Name the calling thread in the trace.
+// @param name The name of the thread.
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadData& data = getThreadData();
+    std::lock_guard<std::mutex> lock(s_ThreadMutex);
+    data.name = name;
+}
+
+// @brief Write the count, mean, p50, p99 and max duration of every scope name, over all threads.
+// @param out The stream to write to.
+void Profiler::writeReport(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock(s_ThreadMutex);
+
+    // Scopes of the same name on different threads, e.g. the tasks run by the workers, are merged
+    std::map<std::string, Histogram> merged;
+    std::uint64_t droppedEvents = 0;
+    for (const std::unique_ptr<ThreadData>& data : s_Threads)
+    {
+        for (const Histogram& histogram : data->histograms)
+        {
+            Histogram& total = merged[histogram.name];
+            total.count += histogram.count;
+            total.total += histogram.total;
+            total.max = std::max(total.max, histogram.max);
+            for (int i = 0; i < bucketCount; i++)
+            {
+                total.buckets[i] += histogram.buckets[i];
+            }
+        }
+        droppedEvents += data->droppedEvents;
+    }
+
+    std::ios::fmtflags flags = out.flags();
+    out << std::left << std::setw(24) << "scope (us)" << std::right << std::setw(10) << "count"
+        << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (const auto& entry : merged)
+    {
+        const Histogram& histogram = entry.second;
+        out << std::left << std::setw(24) << entry.first << std::right << std::setw(10) << histogram.count
+            << std::setw(10) << histogram.total / 1000. / histogram.count
+            << std::setw(10) << getPercentile(histogram, .5) / 1000.
+            << std::setw(10) << getPercentile(histogram, .99) / 1000.
+            << std::setw(10) << histogram.max / 1000. << "\n";
+    }
+
+    if (droppedEvents > 0)
+    {
+        out << droppedEvents << " scopes are in the histograms but not in the trace" << "\n";
+    }
+    out.flags(flags);
+}
+
+// @brief Write every recorded scope as a Chrome trace.
+// @param filename The JSON file, replaced if it exists.
+// @return False if the file could not be written.
+bool Profiler::writeChromeTrace(const std::string& filename)
+{
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_ThreadMutex);
+
+    // Complete events ("X") with their start and duration in microseconds
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (const std::unique_ptr<ThreadData>& data : s_Threads)
+    {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << data->id
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, data->name);
+        out << "}}";
+        first = false;
+
+        for (const Event& event : data->events)
+        {
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << data->id << ",\"ts\":" << event.start / 1000.
+                << ",\"dur\":" << event.duration / 1000. << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    return static_cast<bool>(out);
+}
+
+#else
+
+// Does nothing, the profiler is compiled out.
+Profiler::Scope::Scope(const char* name) : m_Name(name), m_Start(0)
+{
+}
+
+// Does nothing, the profiler is compiled out.
+Profiler::Scope::~Scope()
+{
+}
+
+// @brief Check whether scopes are being recorded in this build.
+// @return False, the profiler is compiled out.
+bool Profiler::isEnabled()
+{
+    return false;
+}
+
+// @brief Does nothing, the profiler is compiled out.
+void Profiler::setThreadName(const std::string&)
+{
+}
+
+// @brief Does nothing, the profiler is compiled out.
+void Profiler::writeReport(std::ostream&)
+{
+}
+
+// @brief Does nothing, the profiler is compiled out.
+// @return False, there is no trace to write.
+bool Profiler::writeChromeTrace(const std::string&)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file declares the frame profiler. PROFILE_SCOPE("name") times the rest of the enclosing block;
+every thread records its own scopes, into a histogram per scope name and into a list of events that can be
+written as a Chrome trace and opened in chrome://tracing or https://ui.perfetto.dev.
+When the project is configured with LAB1_PROFILE the scopes are compiled in, without it PROFILE_SCOPE
+expands to nothing and the profiler reports no data.
+*/
+
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifdef LAB1_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+namespace Profiler
+{
+    // Times the block it lives in
+    class Scope
+    {
+    private:
+        const char* m_Name;
+        std::int64_t m_Start;
+
+    public:
+        // @param name The name of the scope, must live as long as the process, see intern.
+        explicit Scope(const char* name);
+
+        // Records the scope.
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // @brief Check whether scopes are being recorded in this build.
+    // @return True when built with LAB1_PROFILE.
+    bool isEnabled();
+
+    // @brief Get a copy of a name that lives as long as the process, for scopes named at run time.
+    // @param name The name.
+    // @return The same pointer for equal names.
+    const char* intern(const std::string& name);
+
+    // @brief Name the calling thread in the trace.
+    // @param name The name of the thread.
+    void setThreadName(const std::string& name);
+
+    // @brief Write the count, mean, p50, p99 and max duration of every scope name, over all threads.
+    //        No scope may be running while the report is written.
+    // @param out The stream to write to.
+    void writeReport(std::ostream& out);
+
+    // @brief Write every recorded scope as a Chrome trace.
+    //        No scope may be running while the trace is written.
+    // @param filename The JSON file, replaced if it exists.
+    // @return False if the file could not be written.
+    bool writeChromeTrace(const std::string& filename);
+}
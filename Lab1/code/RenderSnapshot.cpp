@@ -0,0 +1,95 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the RenderSnapshot struct, the hand-off between the simulation thread and the render thread.
+*/
+
+#include "RenderSnapshot.h"
+
+// @brief Copy the drawable state of the world and clear the changes of its mushroom field.
+// @param world The game.
+// @param now The time of the capture.
+// @param keepChanges True if the previous content of this snapshot was never drawn, its mushroom changes are kept.
+void RenderSnapshot::capture(GameWorld& world, Time now, bool keepChanges)
+{
+    MushroomField& field = world.getMushrooms();
+
+    // The changes of a snapshot that was dropped have not been drawn yet
+    if (!keepChanges)
+    {
+        dirtyCells.clear();
+        allDirty = false;
+    }
+    allDirty = allDirty || field.isAllDirty();
+    if (!allDirty)
+    {
+        dirtyCells.insert(dirtyCells.end(), field.getDirtyCells().begin(), field.getDirtyCells().end());
+    }
+
+    // Changes kept over many dropped snapshots may list cells twice, past the size of the grid redraw everything
+    if (dirtyCells.size() > static_cast<size_t>(field.getColumns() * field.getRows()))
+    {
+        allDirty = true;
+    }
+    if (allDirty)
+    {
+        dirtyCells.clear();
+    }
+    field.clearDirty();
+
+    // The render thread only reads the mushrooms to redraw the cells that changed
+    if (allDirty || !dirtyCells.empty())
+    {
+        mushrooms.assign(field.begin(), field.end());
+        mushroomCells.clear();
+        for (int row = 0; row < field.getRows(); row++)
+        {
+            for (int column = 0; column < field.getColumns(); column++)
+            {
+                mushroomCells.push_back(field.getAt(column, row));
+            }
+        }
+    }
+
+    lasers.clear();
+    for (const Laser& laser : world.getLasers())
+    {
+        const RectangleShape& shape = laser.getShape();
+        lasers.push_back({ FloatRect(shape.getPosition(), shape.getSize()), shape.getFillColor(), laser.getRenderOffset(0) });
+    }
+
+    sprites.clear();
+    if (world.isSpiderActive())
+    {
+        const Spider& spider = world.getSpider();
+        sprites.push_back({ spider.getShape(), spider.getRenderOffset(0) });
+    }
+
+    const Starship& starship = world.getStarship();
+    sprites.push_back({ starship.getShape(), starship.getRenderOffset(0) });
+
+    for (auto& centipede : world.getCentipedes())
+    {
+        for (const CentipedeComponent& segment : centipede.getSegments())
+        {
+            sprites.push_back({ segment.getShape(), segment.getRenderOffset(0) });
+        }
+    }
+
+    state = world.getState();
+    score = world.getScore();
+    lives = world.getLives();
+    stepEnd = now;
+}
+
+// @brief Get the offset of an interpolated object from its current position.
+// @param previousOffset The offset back to the previous step.
+// @param alpha How far the frame is between the previous and the current step, in [0, 1].
+// @return The translation to apply when drawing.
+Vector2f RenderSnapshot::interpolate(Vector2f previousOffset, float alpha)
+{
+    return previousOffset * (1.f - alpha);
+}
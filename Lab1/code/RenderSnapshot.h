@@ -0,0 +1,71 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the RenderSnapshot struct, a copy of everything the render thread draws, taken by the
+simulation thread after its steps. Moving objects are recorded with their position at the previous step so the
+render thread can interpolate them, and the mushroom cells that changed are passed on to the static layer.
+The mushrooms are only copied when cells changed, since the static layer only reads them to redraw those cells.
+The vectors keep their memory from one capture to the next, so taking a snapshot does not allocate.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "GameWorld.h"
+
+using namespace sf;
+
+struct RenderSnapshot
+{
+    // A sprite and its offset back to the previous step
+    struct SpriteInstance
+    {
+        Sprite sprite;
+        Vector2f previousOffset;
+    };
+
+    // A filled rectangle and its offset back to the previous step
+    struct RectInstance
+    {
+        FloatRect bounds;
+        Color color;
+        Vector2f previousOffset;
+    };
+
+    // The grid cells that changed since the previous snapshot the render thread saw
+    std::vector<int> dirtyCells;
+    bool allDirty = true;
+
+    // The mushrooms and the index of the mushroom in each grid cell, or MushroomField::EMPTY.
+    // Only up to date when allDirty is set or dirtyCells is not empty.
+    std::vector<Sprite> mushrooms;
+    std::vector<int> mushroomCells;
+
+    // Moving objects in drawing order
+    std::vector<RectInstance> lasers;
+    std::vector<SpriteInstance> sprites;
+
+    // Game status
+    GameWorld::State state = GameWorld::State::Title;
+    int score = 0;
+    int lives = 0;
+
+    // When the last simulation step of the snapshot ended
+    Time stepEnd;
+
+    // @brief Copy the drawable state of the world and clear the changes of its mushroom field.
+    // @param world The game.
+    // @param now The time of the capture.
+    // @param keepChanges True if the previous content of this snapshot was never drawn, its mushroom changes are kept.
+    void capture(GameWorld& world, Time now, bool keepChanges);
+
+    // @brief Get the offset of an interpolated object from its current position.
+    // @param previousOffset The offset back to the previous step.
+    // @param alpha How far the frame is between the previous and the current step, in [0, 1].
+    // @return The translation to apply when drawing.
+    static Vector2f interpolate(Vector2f previousOffset, float alpha);
+};
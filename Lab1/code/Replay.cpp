@@ -0,0 +1,439 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the ReplayRecorder and ReplayPlayer classes. Integers are written byte by byte,
+so the inputs of a replay read the same on every platform; the keyframes hold raw world states and are
+only meant for the build that wrote them.
+*/
+
+#include <algorithm>
+
+#include "Replay.h"
+
+// Identifies a replay file, its layout and its trailer
+static const char replayMagic[4] = { 'L', '1', 'R', 'P' };
+static const char indexMagic[4] = { 'L', '1', 'R', 'I' };
+static const unsigned char replayVersion = 2;
+
+// Size of the header and of the trailer in bytes
+static const size_t headerSize = 4 + 1 + 4 + 8 + 4;
+static const size_t trailerSize = 8 + 4;
+
+// Bits of the controls in a packed input
+enum InputBit
+{
+    LeftBit = 1 << 0,
+    RightBit = 1 << 1,
+    UpBit = 1 << 2,
+    DownBit = 1 << 3,
+    FireBit = 1 << 4,
+    StartBit = 1 << 5,
+    KeyReleasedBit = 1 << 6
+};
+
+// @brief Write an unsigned integer in little-endian order.
+static void writeFixed(std::ostream& out, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// @brief Write an unsigned integer 7 bits at a time, small values take a single byte.
+static void writeVarint(std::ostream& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+// @brief Read an unsigned integer written by writeFixed from mapped bytes.
+// @param cursor The offset to read at, moved past the integer.
+static bool readFixed(const MappedFile& file, size_t& cursor, std::uint64_t& value, int bytes)
+{
+    if (cursor > file.size() || file.size() - cursor < static_cast<size_t>(bytes))
+    {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(file.data()[cursor++])) << (8 * i);
+    }
+    return true;
+}
+
+// @brief Read an unsigned integer written by writeVarint from mapped bytes.
+// @param cursor The offset to read at, moved past the integer.
+static bool readVarint(const MappedFile& file, size_t& cursor, std::uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && cursor < file.size(); shift += 7)
+    {
+        unsigned char byte = static_cast<unsigned char>(file.data()[cursor++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// @brief Pack the controls of a step into the bits of a byte.
+// @param input The controls.
+// @return The bits of the controls.
+unsigned char packInput(const InputState& input)
+{
+    return static_cast<unsigned char>((input.left ? LeftBit : 0) | (input.right ? RightBit : 0) |
+        (input.up ? UpBit : 0) | (input.down ? DownBit : 0) | (input.fire ? FireBit : 0) |
+        (input.start ? StartBit : 0) | (input.keyReleased ? KeyReleasedBit : 0));
+}
+
+// @brief Unpack the controls of a step.
+// @param bits The bits written by packInput.
+// @return The controls.
+InputState unpackInput(unsigned char bits)
+{
+    InputState input;
+    input.left = bits & LeftBit;
+    input.right = bits & RightBit;
+    input.up = bits & UpBit;
+    input.down = bits & DownBit;
+    input.fire = bits & FireBit;
+    input.start = bits & StartBit;
+    input.keyReleased = bits & KeyReleasedBit;
+    return input;
+}
+
+// @brief Start a replay file. With keyframes, the first one holds the world before its first step,
+//        so every step can be reached from a keyframe.
+// @param filename The file, replaced if it exists.
+// @param world The world being recorded, before its first recorded step.
+// @param step The simulation step.
+// @param keyframeInterval Steps between two keyframes, 0 to only store the inputs.
+// @return False if the file could not be written.
+bool ReplayRecorder::open(const std::string& filename, const GameWorld& world, Time step, int keyframeInterval)
+{
+    m_File.open(filename, std::ios::binary | std::ios::trunc);
+    m_KeyframeInterval = std::max(keyframeInterval, 0);
+    m_RunLength = 0;
+    m_Steps = 0;
+    m_Keyframes.clear();
+
+    m_File.write(replayMagic, sizeof(replayMagic));
+    m_File.put(static_cast<char>(replayVersion));
+    writeFixed(m_File, world.getSeed(), 4);
+    writeFixed(m_File, static_cast<std::uint64_t>(step.asMicroseconds()), 8);
+    writeFixed(m_File, static_cast<std::uint64_t>(m_KeyframeInterval), 4);
+
+    if (m_KeyframeInterval > 0)
+    {
+        writeKeyframe(world);
+    }
+    return static_cast<bool>(m_File);
+}
+
+// @brief Check whether a replay is being recorded.
+bool ReplayRecorder::isOpen() const
+{
+    return m_File.is_open();
+}
+
+// @brief Write the current run, if any.
+void ReplayRecorder::flushRun()
+{
+    if (m_RunLength > 0)
+    {
+        m_File.put(static_cast<char>(m_RunInput));
+        writeVarint(m_File, m_RunLength);
+        m_RunLength = 0;
+    }
+}
+
+// @brief Write the state the world reached after the steps recorded so far.
+void ReplayRecorder::writeKeyframe(const GameWorld& world)
+{
+    // A run never spans a keyframe, so playing can resume right after one
+    flushRun();
+
+    m_State.clear();
+    world.saveState(m_State);
+
+    m_Keyframes.push_back(ReplayKeyframe{ m_Steps, static_cast<std::uint64_t>(m_File.tellp()) });
+    m_File.put(static_cast<char>(KEYFRAME_MARKER));
+    writeVarint(m_File, m_Steps);
+    writeFixed(m_File, world.getChecksum(), 8);
+    writeVarint(m_File, m_State.size());
+    m_File.write(m_State.data(), static_cast<std::streamsize>(m_State.size()));
+}
+
+// @brief Record the controls of one step, and a keyframe every keyframe interval.
+// @param input The controls passed to GameWorld::step.
+// @param world The world, after the step.
+void ReplayRecorder::record(const InputState& input, const GameWorld& world)
+{
+    unsigned char bits = packInput(input);
+    if (m_RunLength > 0 && bits != m_RunInput)
+    {
+        flushRun();
+    }
+
+    m_RunInput = bits;
+    m_RunLength++;
+    m_Steps++;
+
+    if (m_KeyframeInterval > 0 && m_Steps % m_KeyframeInterval == 0)
+    {
+        writeKeyframe(world);
+    }
+}
+
+// @brief Finish the replay with the state the world reached and the index of the keyframes.
+// @param world The recorded world, after its last recorded step.
+// @return False if the file could not be written.
+bool ReplayRecorder::close(const GameWorld& world)
+{
+    flushRun();
+
+    std::uint64_t end = static_cast<std::uint64_t>(m_File.tellp());
+    m_File.put(static_cast<char>(END_MARKER));
+    writeFixed(m_File, m_Steps, 8);
+    writeFixed(m_File, world.getChecksum(), 8);
+    writeFixed(m_File, m_Keyframes.size(), 4);
+    for (const ReplayKeyframe& keyframe : m_Keyframes)
+    {
+        writeFixed(m_File, keyframe.step, 8);
+        writeFixed(m_File, keyframe.offset, 8);
+    }
+
+    writeFixed(m_File, end, 8);
+    m_File.write(indexMagic, sizeof(indexMagic));
+
+    bool written = static_cast<bool>(m_File);
+    m_File.close();
+    return written;
+}
+
+// @brief Get the number of steps recorded.
+std::uint64_t ReplayRecorder::getSteps() const
+{
+    return m_Steps;
+}
+
+// @brief Map a replay file and read its header and index.
+// @param filename The file.
+// @return False if the file cannot be read or is not a replay.
+bool ReplayPlayer::open(const std::string& filename)
+{
+    m_RunLeft = 0;
+    m_Steps = 0;
+    m_Ended = false;
+    m_Keyframes.clear();
+
+    if (!m_File.open(filename) || m_File.size() < headerSize ||
+        !std::equal(replayMagic, replayMagic + sizeof(replayMagic), m_File.data()) ||
+        static_cast<unsigned char>(m_File.data()[4]) != replayVersion)
+    {
+        return false;
+    }
+
+    std::uint64_t seed, step, interval;
+    m_Cursor = 5;
+    readFixed(m_File, m_Cursor, seed, 4);
+    readFixed(m_File, m_Cursor, step, 8);
+    readFixed(m_File, m_Cursor, interval, 4);
+    m_Seed = static_cast<unsigned>(seed);
+    m_Step = microseconds(static_cast<Int64>(step));
+    m_KeyframeInterval = static_cast<int>(interval);
+
+    m_HasIndex = readIndex();
+    return true;
+}
+
+// @brief Read the index the trailer points to.
+// @return False if the file has no valid index, e.g. when the recording was interrupted.
+bool ReplayPlayer::readIndex()
+{
+    size_t size = m_File.size();
+    if (size < headerSize + trailerSize ||
+        !std::equal(indexMagic, indexMagic + sizeof(indexMagic), m_File.data() + size - sizeof(indexMagic)))
+    {
+        return false;
+    }
+
+    std::uint64_t end, count;
+    size_t cursor = size - trailerSize;
+    if (!readFixed(m_File, cursor, end, 8) || end < headerSize || end >= size ||
+        static_cast<unsigned char>(m_File.data()[end]) != ReplayRecorder::END_MARKER)
+    {
+        return false;
+    }
+
+    cursor = static_cast<size_t>(end) + 1;
+    if (!readFixed(m_File, cursor, m_TotalSteps, 8) || !readFixed(m_File, cursor, m_Checksum, 8) ||
+        !readFixed(m_File, cursor, count, 4))
+    {
+        return false;
+    }
+
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        ReplayKeyframe keyframe;
+        if (!readFixed(m_File, cursor, keyframe.step, 8) || !readFixed(m_File, cursor, keyframe.offset, 8))
+        {
+            m_Keyframes.clear();
+            return false;
+        }
+        m_Keyframes.push_back(keyframe);
+    }
+    return true;
+}
+
+// @brief Get the seed to create the world with.
+unsigned ReplayPlayer::getSeed() const
+{
+    return m_Seed;
+}
+
+// @brief Get the simulation step the replay was recorded with.
+Time ReplayPlayer::getStep() const
+{
+    return m_Step;
+}
+
+// @brief Read the controls of the next step, skipping the keyframes.
+// @param input Set to the controls.
+// @return False once every step was played, or if the file is truncated.
+bool ReplayPlayer::next(InputState& input)
+{
+    while (m_RunLeft == 0)
+    {
+        if (m_Ended || m_Cursor >= m_File.size())
+        {
+            return false;
+        }
+
+        unsigned char bits = static_cast<unsigned char>(m_File.data()[m_Cursor++]);
+        if (bits == ReplayRecorder::END_MARKER)
+        {
+            // The totals follow the marker
+            m_Ended = readFixed(m_File, m_Cursor, m_TotalSteps, 8) && readFixed(m_File, m_Cursor, m_Checksum, 8);
+            return false;
+        }
+
+        if (bits == ReplayRecorder::KEYFRAME_MARKER)
+        {
+            std::uint64_t step, checksum, size;
+            if (!readVarint(m_File, m_Cursor, step) || !readFixed(m_File, m_Cursor, checksum, 8) ||
+                !readVarint(m_File, m_Cursor, size) || size > m_File.size() - m_Cursor)
+            {
+                return false;
+            }
+            m_Cursor += static_cast<size_t>(size);
+            continue;
+        }
+
+        m_RunInput = bits;
+        if (!readVarint(m_File, m_Cursor, m_RunLeft))
+        {
+            return false;
+        }
+    }
+
+    m_RunLeft--;
+    m_Steps++;
+    input = unpackInput(m_RunInput);
+    return true;
+}
+
+// @brief Bring a world to the state it had after a number of steps.
+// @param step The number of steps played.
+// @param world The world to set.
+// @return False if the step is past the end or a keyframe is malformed.
+bool ReplayPlayer::seek(std::uint64_t step, GameWorld& world)
+{
+    if (m_HasIndex && step > m_TotalSteps)
+    {
+        return false;
+    }
+
+    // The last keyframe at or before the step
+    auto it = std::upper_bound(m_Keyframes.begin(), m_Keyframes.end(), step,
+        [](std::uint64_t value, const ReplayKeyframe& keyframe) { return value < keyframe.step; });
+    if (it == m_Keyframes.begin())
+    {
+        return false;
+    }
+    const ReplayKeyframe& keyframe = *(it - 1);
+
+    size_t cursor = static_cast<size_t>(keyframe.offset);
+    std::uint64_t keyframeStep, checksum, size;
+    if (cursor >= m_File.size() || static_cast<unsigned char>(m_File.data()[cursor++]) != ReplayRecorder::KEYFRAME_MARKER ||
+        !readVarint(m_File, cursor, keyframeStep) || !readFixed(m_File, cursor, checksum, 8) ||
+        !readVarint(m_File, cursor, size) || size > m_File.size() - cursor || keyframeStep != keyframe.step)
+    {
+        return false;
+    }
+
+    // The checksum proves the state was restored completely
+    if (!world.loadState(m_File.data() + cursor, static_cast<size_t>(size)) || world.getChecksum() != checksum)
+    {
+        return false;
+    }
+
+    m_Cursor = cursor + static_cast<size_t>(size);
+    m_Steps = keyframe.step;
+    m_RunLeft = 0;
+    m_Ended = false;
+
+    // Simulate the steps after the keyframe
+    InputState input;
+    while (m_Steps < step)
+    {
+        if (!next(input))
+        {
+            return false;
+        }
+        world.step(m_Step, input);
+    }
+    return true;
+}
+
+// @brief Check whether every recorded step was played and the end of the replay was read.
+bool ReplayPlayer::isComplete() const
+{
+    return m_Ended && m_RunLeft == 0 && m_Steps == m_TotalSteps;
+}
+
+// @brief Get the number of steps played.
+std::uint64_t ReplayPlayer::getSteps() const
+{
+    return m_Steps;
+}
+
+// @brief Get the number of steps recorded, valid if the replay has an index.
+std::uint64_t ReplayPlayer::getTotalSteps() const
+{
+    return m_TotalSteps;
+}
+
+// @brief Get the number of keyframes in the index.
+int ReplayPlayer::getKeyframeCount() const
+{
+    return static_cast<int>(m_Keyframes.size());
+}
+
+// @brief Get the checksum of the world at the end of the recording, valid once isComplete().
+std::uint64_t ReplayPlayer::getChecksum() const
+{
+    return m_Checksum;
+}
@@ -0,0 +1,177 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the ReplayRecorder and ReplayPlayer classes, which write and read the replay of a
+game. A GameWorld is fully determined by its seed and the inputs of its steps, so a replay mostly stores
+those. The inputs of a step fit in one byte and are stored as runs of identical inputs, since a player holds
+the same keys for many steps. Every few thousand steps the replay also stores a keyframe, the complete state
+of the world, so a player can seek to any step by loading the nearest keyframe before it and simulating the
+few steps after it. The player reads the file through a memory mapping and only touches the pages it needs.
+
+File layout, integers in little-endian order:
+    header:   "L1RP", version (1 byte), seed (4 bytes), step in microseconds (8 bytes),
+              keyframe interval in steps (4 bytes)
+    records:  input run:  input bits below 0x80 (1 byte), number of steps (LEB128 varint)
+              keyframe:   KEYFRAME_MARKER (1 byte), step (varint), checksum of the world (8 bytes),
+                          size of the state (varint), state written by GameWorld::saveState
+              end:        END_MARKER (1 byte), followed by the index
+    index:    number of steps (8 bytes), checksum of the final world (8 bytes), number of keyframes (4 bytes),
+              then the step and the file offset of every keyframe (8 + 8 bytes)
+    trailer:  offset of the end record (8 bytes), "L1RI"
+*/
+
+#pragma once
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "GameWorld.h"
+#include "MappedFile.h"
+
+using namespace sf;
+
+// @brief Pack the controls of a step into the bits of a byte.
+// @param input The controls.
+// @return The bits of the controls, below 0x80.
+unsigned char packInput(const InputState& input);
+
+// @brief Unpack the controls of a step.
+// @param bits The bits written by packInput.
+// @return The controls.
+InputState unpackInput(unsigned char bits);
+
+// Where a keyframe is in a replay file
+struct ReplayKeyframe
+{
+    std::uint64_t step;
+    std::uint64_t offset;
+};
+
+class ReplayRecorder
+{
+public:
+    // Start a keyframe and the end of a replay, never the bits of an input
+    static const unsigned char KEYFRAME_MARKER = 0xFE;
+    static const unsigned char END_MARKER = 0xFF;
+
+    // Steps between two keyframes by default, 10 seconds at 120 Hz
+    static const int DEFAULT_KEYFRAME_INTERVAL = 1200;
+
+private:
+    std::ofstream m_File;
+    int m_KeyframeInterval = 0;
+
+    // The run being recorded
+    unsigned char m_RunInput = 0;
+    std::uint64_t m_RunLength = 0;
+
+    // Steps recorded so far
+    std::uint64_t m_Steps = 0;
+
+    // The keyframes written so far, and a buffer reused for their state
+    std::vector<ReplayKeyframe> m_Keyframes;
+    std::vector<char> m_State;
+
+    // @brief Write the current run, if any.
+    void flushRun();
+
+    // @brief Write the state the world reached after the steps recorded so far.
+    void writeKeyframe(const GameWorld& world);
+
+public:
+    // @brief Start a replay file.
+    // @param filename The file, replaced if it exists.
+    // @param world The world being recorded, before its first recorded step.
+    // @param step The simulation step.
+    // @param keyframeInterval Steps between two keyframes, 0 to only store the inputs.
+    // @return False if the file could not be written.
+    bool open(const std::string& filename, const GameWorld& world, Time step, int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    // @brief Check whether a replay is being recorded.
+    bool isOpen() const;
+
+    // @brief Record the controls of one step, and a keyframe every keyframe interval.
+    // @param input The controls passed to GameWorld::step.
+    // @param world The world, after the step.
+    void record(const InputState& input, const GameWorld& world);
+
+    // @brief Finish the replay with the state the world reached and the index of the keyframes.
+    // @param world The recorded world, after its last recorded step.
+    // @return False if the file could not be written.
+    bool close(const GameWorld& world);
+
+    // @brief Get the number of steps recorded.
+    std::uint64_t getSteps() const;
+};
+
+class ReplayPlayer
+{
+private:
+    MappedFile m_File;
+    size_t m_Cursor = 0;
+
+    unsigned m_Seed = 0;
+    Time m_Step;
+    int m_KeyframeInterval = 0;
+
+    // What is left of the run being played
+    unsigned char m_RunInput = 0;
+    std::uint64_t m_RunLeft = 0;
+
+    // Steps played so far, and the totals read from the index
+    std::uint64_t m_Steps = 0;
+    std::uint64_t m_TotalSteps = 0;
+    std::uint64_t m_Checksum = 0;
+    bool m_HasIndex = false;
+    bool m_Ended = false;
+
+    std::vector<ReplayKeyframe> m_Keyframes;
+
+    // @brief Read the index the trailer points to.
+    // @return False if the file has no valid index, e.g. when the recording was interrupted.
+    bool readIndex();
+
+public:
+    // @brief Map a replay file and read its header and index.
+    // @param filename The file.
+    // @return False if the file cannot be read or is not a replay.
+    bool open(const std::string& filename);
+
+    // @brief Get the seed to create the world with.
+    unsigned getSeed() const;
+
+    // @brief Get the simulation step the replay was recorded with.
+    Time getStep() const;
+
+    // @brief Read the controls of the next step, skipping the keyframes.
+    // @param input Set to the controls.
+    // @return False once every step was played, or if the file is truncated.
+    bool next(InputState& input);
+
+    // @brief Bring a world to the state it had after a number of steps: load the last keyframe at or before
+    //        the step, then simulate the steps after it. Playing continues from there.
+    // @param step The number of steps played.
+    // @param world The world to set, created with any seed.
+    // @return False if the step is past the end or a keyframe is malformed.
+    bool seek(std::uint64_t step, GameWorld& world);
+
+    // @brief Check whether every recorded step was played and the end of the replay was read.
+    bool isComplete() const;
+
+    // @brief Get the number of steps played.
+    std::uint64_t getSteps() const;
+
+    // @brief Get the number of steps recorded, valid if the replay has an index.
+    std::uint64_t getTotalSteps() const;
+
+    // @brief Get the number of keyframes in the index.
+    int getKeyframeCount() const;
+
+    // @brief Get the checksum of the world at the end of the recording, valid once isComplete().
+    std::uint64_t getChecksum() const;
+};
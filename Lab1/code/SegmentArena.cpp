@@ -0,0 +1,133 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the SegmentArena class, the contiguous store shared by all the centipedes.
+*/
+
+#include "AllocationCounter.h"
+#include "SegmentArena.h"
+
+// Constructor that creates an empty arena.
+// @param resource The memory resource the segments are allocated from.
+SegmentArena::SegmentArena(std::pmr::memory_resource* resource)
+    : m_Segments(resource), m_Left(resource), m_Top(resource), m_Right(resource), m_Bottom(resource)
+{
+}
+
+// @brief Add a segment at the end of the arena.
+// @param segment The segment to add.
+// @return The index of the new segment.
+int SegmentArena::append(const CentipedeComponent& segment)
+{
+    AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+    m_Segments.push_back(segment);
+    m_Left.push_back(0.f);
+    m_Top.push_back(0.f);
+    m_Right.push_back(0.f);
+    m_Bottom.push_back(0.f);
+    setBounds(size() - 1, segment.getPosition());
+    return size() - 1;
+}
+
+// @brief Get a segment.
+// @param index The index of the segment in the arena.
+// @return A reference to the segment.
+CentipedeComponent& SegmentArena::operator[](int index)
+{
+    return m_Segments[index];
+}
+
+const CentipedeComponent& SegmentArena::operator[](int index) const
+{
+    return m_Segments[index];
+}
+
+// @brief Store the collision bounds of a segment in the packed arrays.
+// @param index The index of the segment in the arena.
+// @param bounds The bounds of the segment, their size is never negative.
+void SegmentArena::setBounds(int index, const FloatRect& bounds)
+{
+    m_Left[index] = bounds.left;
+    m_Top[index] = bounds.top;
+    m_Right[index] = bounds.left + bounds.width;
+    m_Bottom[index] = bounds.top + bounds.height;
+}
+
+// @brief Get the packed collision bounds of the segments.
+// @param first The index of the segment the arrays start at.
+// @return The arrays.
+PackedBoxes SegmentArena::getBoxes(int first) const
+{
+    return PackedBoxes{ m_Left.data() + first, m_Top.data() + first, m_Right.data() + first, m_Bottom.data() + first };
+}
+
+// @brief Get the first segment of the arena, for building views over ranges.
+// @return A pointer to the contiguous segments.
+const CentipedeComponent* SegmentArena::data() const
+{
+    return m_Segments.data();
+}
+
+// @brief Get the number of segments in the arena.
+// @return The size of the arena.
+int SegmentArena::size() const
+{
+    return static_cast<int>(m_Segments.size());
+}
+
+// @brief Reserve room for segments so appending does not reallocate.
+// @param count The number of segments to reserve.
+void SegmentArena::reserve(int count)
+{
+    AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+    m_Segments.reserve(count);
+    m_Left.reserve(count);
+    m_Top.reserve(count);
+    m_Right.reserve(count);
+    m_Bottom.reserve(count);
+}
+
+// @brief Remove all the segments and give their storage back to the memory resource.
+void SegmentArena::clear()
+{
+    std::pmr::vector<CentipedeComponent>(m_Segments.get_allocator()).swap(m_Segments);
+    for (std::pmr::vector<float>* edges : { &m_Left, &m_Top, &m_Right, &m_Bottom })
+    {
+        std::pmr::vector<float>(edges->get_allocator()).swap(*edges);
+    }
+}
+
+// @brief Save every segment, including the ones no centipede uses anymore.
+// @param writer The state being written.
+void SegmentArena::saveState(StateWriter& writer) const
+{
+    writer.write(size());
+    for (const CentipedeComponent& segment : m_Segments)
+    {
+        segment.saveState(writer);
+    }
+}
+
+// @brief Replace the segments with the ones written by saveState.
+// @param reader The state being read.
+void SegmentArena::loadState(StateReader& reader)
+{
+    AllocationCounter::Tag tag(AllocationCounter::Centipedes);
+    int count = 0;
+    reader.read(count);
+    m_Segments.clear();
+    for (int i = 0; i < count && reader.isValid(); i++)
+    {
+        m_Segments.emplace_back();
+        m_Segments.back().loadState(reader);
+    }
+
+    // The centipedes made of the segments store their bounds
+    m_Left.assign(m_Segments.size(), 0.f);
+    m_Top.assign(m_Segments.size(), 0.f);
+    m_Right.assign(m_Segments.size(), 0.f);
+    m_Bottom.assign(m_Segments.size(), 0.f);
+}
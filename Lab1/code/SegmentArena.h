@@ -0,0 +1,84 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the SegmentArena class, a single contiguous store for the segments of all the centipedes.
+Each Centipede owns a range [begin, end) of the arena, from head to tail. Splitting a centipede only cuts its range
+in two and removing a head or a tail only moves a range bound, so segments never move once they are created.
+Segments that are shot are simply left out of every range; the arena is cleared when a new game starts.
+The segments are allocated from a memory resource, the LevelMemory of the world in the game.
+The collision bounds of the segments are also kept as packed arrays of edges, for the box kernel; the centipedes
+store the bounds of their segments whenever they move them.
+*/
+
+#pragma once
+#include <memory_resource>
+#include <vector>
+
+#include "BoxKernel.h"
+#include "CentipedeComponent.h"
+
+class SegmentArena
+{
+private:
+    // The segments of all the centipedes, each centipede is a contiguous range
+    std::pmr::vector<CentipedeComponent> m_Segments;
+
+    // The edges of the collision bounds of each segment, parallel to m_Segments
+    std::pmr::vector<float> m_Left;
+    std::pmr::vector<float> m_Top;
+    std::pmr::vector<float> m_Right;
+    std::pmr::vector<float> m_Bottom;
+
+public:
+    // Constructor that creates an empty arena.
+    // @param resource The memory resource the segments are allocated from, it must outlive the arena.
+    explicit SegmentArena(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // @brief Add a segment at the end of the arena.
+    // @param segment The segment to add.
+    // @return The index of the new segment.
+    int append(const CentipedeComponent& segment);
+
+    // @brief Get a segment.
+    // @param index The index of the segment in the arena.
+    // @return A reference to the segment, valid until the arena grows.
+    CentipedeComponent& operator[](int index);
+    const CentipedeComponent& operator[](int index) const;
+
+    // @brief Store the collision bounds of a segment in the packed arrays.
+    // @param index The index of the segment in the arena.
+    // @param bounds The bounds of the segment.
+    void setBounds(int index, const FloatRect& bounds);
+
+    // @brief Get the packed collision bounds of the segments, as last stored with setBounds.
+    // @param first The index of the segment the arrays start at.
+    // @return The arrays, valid until the arena grows.
+    PackedBoxes getBoxes(int first) const;
+
+    // @brief Get the first segment of the arena, for building views over ranges.
+    // @return A pointer to the contiguous segments.
+    const CentipedeComponent* data() const;
+
+    // @brief Get the number of segments in the arena, including the ones no centipede uses anymore.
+    // @return The size of the arena.
+    int size() const;
+
+    // @brief Reserve room for segments so appending does not reallocate.
+    // @param count The number of segments to reserve.
+    void reserve(int count);
+
+    // @brief Remove all the segments and give their storage back to the memory resource.
+    //        Every centipede using the arena must be discarded first.
+    void clear();
+
+    // @brief Save every segment, including the ones no centipede uses anymore, so the indices stay valid.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Replace the segments with the ones written by saveState.
+    // @param reader The state being read.
+    void loadState(StateReader& reader);
+};
@@ -1,114 +1,177 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This file contains the implementation of the Spider class, representing the spider object in the game.
-The spider moves randomly on the screen and changes direction periodically.
-The spider's position is updated each frame, and it is constrained to the screen boundaries.
-*/
-
-#include "Spider.h"
-
-// This the constructor function
-// @param startX The starting x-coordinate for the spider.
-// @param startY The starting y-coordinate for the spider.
-Spider::Spider(float startX, float startY)
-{
-    // Initialize the direction change timer and interval
-    m_ChangeDirectionTimer = 0.f;
-    m_DirectionChangeInterval = static_cast<float>(std::rand() % 200 + 100) / 100.0f;
-
-    // Set the starting position of the spider
-    m_startPosition.x = startX;
-    m_startPosition.y = startY;
-    m_Position = m_startPosition;
-
-    // Load the spider texture
-    m_Texture.loadFromFile("graphics/spider.png");
-    m_Shape.setTexture(m_Texture);
-    m_Shape.setPosition(m_Position);
-
-    // Seed random number generator and generate an initial random movement direction
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-    randomMove();
-}
-
-// @brief Get the global bounding box of the spider for collision detection.
-// @return A FloatRect representing the spider's global bounds.
-FloatRect Spider::getPosition()
-{
-    return m_Shape.getGlobalBounds();
-}
-
-// @brief Get the shape of the spider for rendering.
-// @return A Sprite object representing the spider.
-Sprite Spider::getShape()
-{
-    return m_Shape;
-}
-
-// @brief Reset the spider's position to its starting position.
-void Spider::reset()
-{
-    m_Position = m_startPosition;
-}
-
-// @brief Update the spider's position and movement based on the elapsed time.
-// @param dt The elapsed time since the last frame, used to calculate how far the spider should move.
-void Spider::update(Time dt)
-{
-    // Update the change direction timer
-    m_ChangeDirectionTimer += dt.asSeconds();
-    if (m_ChangeDirectionTimer >= m_DirectionChangeInterval)
-    {
-        randomMove();
-        m_DirectionChangeInterval = static_cast<float>(std::rand() % 200 + 100) / 100.0f;
-        m_ChangeDirectionTimer = 0.f; // Reset timer after changing direction
-    }
-
-    // Randomly set the spider's speed
-    m_Speed = static_cast<float>(std::rand() % 200 + 400);
-
-    // Update position based on speed and direction
-    m_Position.x += m_DirectionX * m_Speed * dt.asSeconds();
-    m_Position.y += m_DirectionY * m_Speed * dt.asSeconds();
-
-    // Ensure the spider stays within the screen boundaries
-    if (m_Position.x < 0)
-    {
-        m_Position.x = 0; // Prevent moving left out of bounds
-        m_DirectionX = -m_DirectionX; // Reverse direction
-    }
-    else if (m_Position.x > 1080 - m_Shape.getGlobalBounds().width)
-    { // Subtract width of sprite to stay fully on screen
-        m_Position.x = 1080 - m_Shape.getGlobalBounds().width; // Prevent moving right out of bounds
-        m_DirectionX = -m_DirectionX; // Reverse direction
-    }
-
-    if (m_Position.y < 75)
-    {
-        m_Position.y = 75; // Prevent moving up out of bounds
-        m_DirectionY = -m_DirectionY; // Reverse direction
-    }
-    else if (m_Position.y > 1060 - m_Shape.getGlobalBounds().height)
-    { // Subtract height of sprite to stay fully on screen
-        m_Position.y = 1060 - m_Shape.getGlobalBounds().height; // Prevent moving down out of bounds
-        m_DirectionY = -m_DirectionY; // Reverse direction
-    }
-
-    // Move the spider sprite
-    m_Shape.setPosition(m_Position);
-}
-
-// @brief Randomly set a new direction for the spider to move in.
-void Spider::randomMove()
-{
-    // Generate a random angle in radians
-    float angle = static_cast<float>(std::rand()) / RAND_MAX * 2 * acos(-1);
-
-    // Calculate new direction based on the angle
-    m_DirectionX = std::cos(angle);
-    m_DirectionY = std::sin(angle);
-}
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file contains the implementation of the Spider class, representing the spider object in the game.
+The spider moves randomly on the screen and changes direction periodically.
+The spider's position is updated each frame, and it is constrained to the screen boundaries.
+*/
+
+#include "Spider.h"
+#include "Assets.h"
+
+// This the constructor function
+// @param startX The starting x-coordinate for the spider.
+// @param startY The starting y-coordinate for the spider.
+Spider::Spider(float startX, float startY)
+{
+    // Initialize the direction change timer and interval
+    m_ChangeDirectionTimer = 0.f;
+    randomInterval();
+
+    // Set the starting position of the spider
+    m_startPosition.x = startX;
+    m_startPosition.y = startY;
+    m_Position = m_startPosition;
+
+    // Load the spider texture
+    Assets::setSprite(m_Shape, "graphics/spider.png");
+    m_Shape.setPosition(m_Position);
+    m_Bounds = m_Shape.getGlobalBounds();
+    m_PreviousPosition = m_Position;
+
+    // Generate an initial random movement direction, seed() draws another one
+    randomMove();
+}
+
+// @brief Restart the random engine of the spider and draw a new direction.
+// @param seed The seed of the engine.
+void Spider::seed(unsigned seed)
+{
+    m_Random.seed(seed);
+    m_ChangeDirectionTimer = 0.f;
+    randomInterval();
+    randomMove();
+}
+
+// @brief Draw the time until the next direction change, between 1 and 3 seconds.
+void Spider::randomInterval()
+{
+    m_DirectionChangeInterval = static_cast<float>(std::uniform_int_distribution<int>(100, 299)(m_Random)) / 100.0f;
+}
+
+// @brief Get the global bounding box of the spider for collision detection.
+// @return A FloatRect representing the spider's global bounds.
+FloatRect Spider::getPosition() const
+{
+    return m_Bounds;
+}
+
+// @brief Get the shape of the spider for rendering.
+// @return A reference to the sprite representing the spider.
+const Sprite& Spider::getShape() const
+{
+    return m_Shape;
+}
+
+// @brief Reset the spider's position to its starting position.
+void Spider::reset()
+{
+    m_Position = m_startPosition;
+}
+
+// @brief Update the spider's position and movement based on the elapsed time.
+// @param dt The elapsed time since the last frame, used to calculate how far the spider should move.
+void Spider::update(Time dt)
+{
+    // Update the change direction timer
+    m_ChangeDirectionTimer += dt.asSeconds();
+    if (m_ChangeDirectionTimer >= m_DirectionChangeInterval)
+    {
+        randomMove();
+        randomInterval();
+        m_ChangeDirectionTimer = 0.f; // Reset timer after changing direction
+    }
+
+    // Randomly set the spider's speed
+    m_Speed = static_cast<float>(std::uniform_int_distribution<int>(400, 599)(m_Random));
+
+    // Update position based on speed and direction
+    m_Position.x += m_DirectionX * m_Speed * dt.asSeconds();
+    m_Position.y += m_DirectionY * m_Speed * dt.asSeconds();
+
+    // Ensure the spider stays within the screen boundaries
+    if (m_Position.x < 0)
+    {
+        m_Position.x = 0; // Prevent moving left out of bounds
+        m_DirectionX = -m_DirectionX; // Reverse direction
+    }
+    else if (m_Position.x > 1080 - m_Shape.getGlobalBounds().width)
+    { // Subtract width of sprite to stay fully on screen
+        m_Position.x = 1080 - m_Shape.getGlobalBounds().width; // Prevent moving right out of bounds
+        m_DirectionX = -m_DirectionX; // Reverse direction
+    }
+
+    if (m_Position.y < 75)
+    {
+        m_Position.y = 75; // Prevent moving up out of bounds
+        m_DirectionY = -m_DirectionY; // Reverse direction
+    }
+    else if (m_Position.y > 1060 - m_Shape.getGlobalBounds().height)
+    { // Subtract height of sprite to stay fully on screen
+        m_Position.y = 1060 - m_Shape.getGlobalBounds().height; // Prevent moving down out of bounds
+        m_DirectionY = -m_DirectionY; // Reverse direction
+    }
+
+    // Move the spider sprite
+    m_Shape.setPosition(m_Position);
+    m_Bounds = m_Shape.getGlobalBounds();
+}
+
+// @brief Randomly set a new direction for the spider to move in.
+void Spider::randomMove()
+{
+    // Generate a random angle in radians
+    float angle = std::uniform_real_distribution<float>(0.f, 2 * std::acos(-1.f))(m_Random);
+
+    // Calculate new direction based on the angle
+    m_DirectionX = std::cos(angle);
+    m_DirectionY = std::sin(angle);
+}
+
+// @brief Remember the current position as the start of a new simulation step.
+void Spider::savePosition()
+{
+    m_PreviousPosition = m_Shape.getPosition();
+}
+
+// @brief Get the offset from the simulated position to the interpolated render position.
+// @param alpha How far the frame is between the previous and the current step, in [0, 1].
+// @return The translation to apply when drawing.
+Vector2f Spider::getRenderOffset(float alpha) const
+{
+    return (m_PreviousPosition - m_Shape.getPosition()) * (1.f - alpha);
+}
+
+// @brief Save the complete state of the spider, its random engine included.
+// @param writer The state being written.
+void Spider::saveState(StateWriter& writer) const
+{
+    writer.write(m_Position);
+    writer.write(m_Speed);
+    writer.write(m_DirectionX);
+    writer.write(m_DirectionY);
+    writer.write(m_ChangeDirectionTimer);
+    writer.write(m_DirectionChangeInterval);
+    writer.write(m_PreviousPosition);
+    writer.writeEngine(m_Random);
+    writer.writeTransform(m_Shape);
+}
+
+// @brief Restore a state written by saveState.
+// @param reader The state being read.
+void Spider::loadState(StateReader& reader)
+{
+    reader.read(m_Position);
+    reader.read(m_Speed);
+    reader.read(m_DirectionX);
+    reader.read(m_DirectionY);
+    reader.read(m_ChangeDirectionTimer);
+    reader.read(m_DirectionChangeInterval);
+    reader.read(m_PreviousPosition);
+    reader.readEngine(m_Random);
+    reader.readTransform(m_Shape);
+    m_Bounds = m_Shape.getGlobalBounds();
+}
@@ -1,65 +1,97 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This header file defines the Spider class, which represents a spider enemy in the game.
-The Spider moves randomly within the game area and changes direction after a certain interval.
-It can reset its position, update its movement based on time, and interact with other game objects.
-*/
-
-#pragma once
-#include <SFML/Graphics.hpp>
-#include <cstdlib>
-#include <ctime>
-#include <cmath>
-
-using namespace sf;
-
-class Spider
-{
-private:
-    // Starting position of the spider
-    Vector2f m_startPosition;
-
-    // Current position of the spider
-    Vector2f m_Position;
-
-    // Texture and sprite of the spider
-    Texture m_Texture;
-    Sprite m_Shape;
-
-    // Speed and direction of the spider's movement
-    float m_Speed;
-    float m_DirectionX;
-    float m_DirectionY;
-
-    // Timers for changing direction at intervals
-    float m_ChangeDirectionTimer;
-    float m_DirectionChangeInterval;
-
-public:
-    // Constructor to initialize the spider with a starting position
-    // @param startX The starting x-coordinate of the spider.
-    // @param startY The starting y-coordinate of the spider.
-    Spider(float startX, float startY);
-
-    // @brief Get the global bounding box of the spider for collision detection.
-    // @return A FloatRect representing the spider's global bounds.
-    FloatRect getPosition();
-
-    // @brief Get the sprite of the spider for rendering.
-    // @return A Sprite object representing the spider.
-    Sprite getShape();
-
-    // @brief Reset the spider's position to its initial starting position.
-    void reset();
-
-    // @brief Update the spider's position and movement based on the elapsed time.
-    // @param dt The time elapsed since the last frame.
-    void update(Time dt);
-
-    // @brief Set a random movement direction for the spider.
-    void randomMove();
-};
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the Spider class, which represents a spider enemy in the game.
+The Spider moves randomly within the game area and changes direction after a certain interval.
+It can reset its position, update its movement based on time, and interact with other game objects.
+Its movement is drawn from a random engine of its own, so a seeded spider always moves the same way.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cmath>
+#include <random>
+#include "StateStream.h"
+
+using namespace sf;
+
+class Spider
+{
+private:
+    // Starting position of the spider
+    Vector2f m_startPosition;
+
+    // Current position of the spider
+    Vector2f m_Position;
+
+    // Sprite of the spider
+    Sprite m_Shape;
+
+    // Global bounds of the sprite, computed once per update so concurrent readers never touch the sprite
+    FloatRect m_Bounds;
+
+    // Speed and direction of the spider's movement
+    float m_Speed;
+    float m_DirectionX;
+    float m_DirectionY;
+
+    // Timers for changing direction at intervals
+    float m_ChangeDirectionTimer;
+    float m_DirectionChangeInterval;
+
+    // Position drawn at the start of the current simulation step, used to interpolate rendering
+    Vector2f m_PreviousPosition;
+
+    // Random engine of the direction, speed and direction changes
+    std::mt19937 m_Random;
+
+    // @brief Draw the time until the next direction change.
+    void randomInterval();
+
+public:
+    // Constructor to initialize the spider with a starting position
+    // @param startX The starting x-coordinate of the spider.
+    // @param startY The starting y-coordinate of the spider.
+    Spider(float startX, float startY);
+
+    // @brief Restart the random engine of the spider and draw a new direction.
+    // @param seed The seed, the same seed always moves the spider the same way.
+    void seed(unsigned seed);
+
+    // @brief Get the global bounding box of the spider for collision detection.
+    // @return A FloatRect representing the spider's global bounds.
+    FloatRect getPosition() const;
+
+    // @brief Get the sprite of the spider for rendering.
+    // @return A reference to the sprite representing the spider.
+    const Sprite& getShape() const;
+
+    // @brief Reset the spider's position to its initial starting position.
+    void reset();
+
+    // @brief Update the spider's position and movement based on the elapsed time.
+    // @param dt The time elapsed since the last frame.
+    void update(Time dt);
+
+    // @brief Set a random movement direction for the spider.
+    void randomMove();
+
+    // @brief Remember the current position as the start of a new simulation step.
+    void savePosition();
+
+    // @brief Get the offset from the simulated position to the interpolated render position.
+    // @param alpha How far the frame is between the previous and the current step, in [0, 1].
+    // @return The translation to apply when drawing.
+    Vector2f getRenderOffset(float alpha) const;
+
+    // @brief Save the complete state of the spider, its random engine included.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Restore a state written by saveState.
+    // @param reader The state being read.
+    void loadState(StateReader& reader);
+};
@@ -1,97 +1,114 @@
-/*
-Author: Cheng-Jung Hsieh
-Class: ECE6122 A
-Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
-
-Description:
-This header file defines the Starship class, which represents the player's starship in the game.
-The Starship can move in all four directions, interact with game objects like mushrooms, and is constrained by screen boundaries.
-*/
-
-#pragma once
-#include <SFML/Graphics.hpp>
-#include <list>
-
-#include "Mushroom.h"
-
-using namespace sf;
-
-class Starship
-{
-private:
-    // Initial position of the starship
-    float m_startX;
-    float m_startY;
-
-    // Movement boundaries for the starship
-    float m_leftBound;
-    float m_rightBound;
-    float m_upBound;
-    float m_downBound;
-
-    // Current position of the starship
-    Vector2f m_Position;
-
-    // Texture and sprite of the starship
-    Texture m_Texture;
-    Sprite m_Sprite;
-
-    // Speed at which the starship moves
-    float m_Speed = 1001.0f;
-
-    // Flags for determining if the starship is moving in a specific direction
-    bool m_MovingRight = false;
-    bool m_MovingLeft = false;
-    bool m_MovingUp = false;
-    bool m_MovingDown = false;
-
-public:
-    // Constructor to initialize the starship with a starting position and movement boundaries
-    // @param startX The starting x-coordinate of the starship.
-    // @param startY The starting y-coordinate of the starship.
-    // @param leftBound The left boundary for the starship's movement.
-    // @param rightBound The right boundary for the starship's movement.
-    // @param upBound The upper boundary for the starship's movement.
-    // @param downBound The lower boundary for the starship's movement.
-    Starship(float startX, float startY, float leftBound, float rightBound, float upBound, float downBound);
-
-    // @brief Reset the starship's position to its initial starting position.
-    void reset();
-
-    // @brief Get the global bounding box of the starship for collision detection.
-    // @return A FloatRect representing the starship's global bounds.
-    FloatRect getPosition();
-
-    // @brief Get the sprite of the starship for rendering.
-    // @return A Sprite object representing the starship.
-    Sprite getShape();
-
-    // @brief Set the starship to move left.
-    void moveLeft();
-
-    // @brief Set the starship to move right.
-    void moveRight();
-
-    // @brief Set the starship to move up.
-    void moveUp();
-
-    // @brief Set the starship to move down.
-    void moveDown();
-
-    // @brief Stop the starship from moving left.
-    void stopLeft();
-
-    // @brief Stop the starship from moving right.
-    void stopRight();
-
-    // @brief Stop the starship from moving up.
-    void stopUp();
-
-    // @brief Stop the starship from moving down.
-    void stopDown();
-
-    // @brief Update the starship's position based on the elapsed time, handle boundary limits, and interact with mushrooms.
-    // @param dt The time elapsed since the last frame.
-    // @param mushrooms A reference to a list of mushrooms that may affect the starship's movement.
-    void update(Time dt, std::list<Mushroom>& mushrooms);
-};
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the Starship class, which represents the player's starship in the game.
+The Starship can move in all four directions, interact with game objects like mushrooms, and is constrained by screen boundaries.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "MushroomField.h"
+#include "StateStream.h"
+
+using namespace sf;
+
+class Starship
+{
+private:
+    // Initial position of the starship
+    float m_startX;
+    float m_startY;
+
+    // Movement boundaries for the starship
+    float m_leftBound;
+    float m_rightBound;
+    float m_upBound;
+    float m_downBound;
+
+    // Current position of the starship
+    Vector2f m_Position;
+
+    // Sprite of the starship
+    Sprite m_Sprite;
+
+    // Speed at which the starship moves
+    float m_Speed = 1001.0f;
+
+    // Flags for determining if the starship is moving in a specific direction
+    bool m_MovingRight = false;
+    bool m_MovingLeft = false;
+    bool m_MovingUp = false;
+    bool m_MovingDown = false;
+
+    // Position drawn at the start of the current simulation step, used to interpolate rendering
+    Vector2f m_PreviousPosition;
+
+public:
+    // Constructor to initialize the starship with a starting position and movement boundaries
+    // @param startX The starting x-coordinate of the starship.
+    // @param startY The starting y-coordinate of the starship.
+    // @param leftBound The left boundary for the starship's movement.
+    // @param rightBound The right boundary for the starship's movement.
+    // @param upBound The upper boundary for the starship's movement.
+    // @param downBound The lower boundary for the starship's movement.
+    Starship(float startX, float startY, float leftBound, float rightBound, float upBound, float downBound);
+
+    // @brief Reset the starship's position to its initial starting position.
+    void reset();
+
+    // @brief Get the global bounding box of the starship for collision detection.
+    // @return A FloatRect representing the starship's global bounds.
+    FloatRect getPosition() const;
+
+    // @brief Get the sprite of the starship for rendering.
+    // @return A reference to the sprite representing the starship.
+    const Sprite& getShape() const;
+
+    // @brief Set the starship to move left.
+    void moveLeft();
+
+    // @brief Set the starship to move right.
+    void moveRight();
+
+    // @brief Set the starship to move up.
+    void moveUp();
+
+    // @brief Set the starship to move down.
+    void moveDown();
+
+    // @brief Stop the starship from moving left.
+    void stopLeft();
+
+    // @brief Stop the starship from moving right.
+    void stopRight();
+
+    // @brief Stop the starship from moving up.
+    void stopUp();
+
+    // @brief Stop the starship from moving down.
+    void stopDown();
+
+    // @brief Update the starship's position based on the elapsed time, handle boundary limits, and interact with mushrooms.
+    // @param dt The time elapsed since the last frame.
+    // @param mushrooms A reference to the mushroom field that may affect the starship's movement.
+    void update(Time dt, const MushroomField& mushrooms);
+
+    // @brief Remember the current position as the start of a new simulation step.
+    void savePosition();
+
+    // @brief Get the offset from the simulated position to the interpolated render position.
+    // @param alpha How far the frame is between the previous and the current step, in [0, 1].
+    // @return The translation to apply when drawing.
+    Vector2f getRenderOffset(float alpha) const;
+
+    // @brief Save the position and the movement of the starship.
+    // @param writer The state being written.
+    void saveState(StateWriter& writer) const;
+
+    // @brief Restore a state written by saveState.
+    // @param reader The state being read.
+    void loadState(StateReader& reader);
+};
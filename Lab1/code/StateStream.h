@@ -0,0 +1,145 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the StateWriter and StateReader classes, which save and restore the state of the
+game objects as raw bytes. Values are copied bit for bit, so a restored world continues exactly like the
+saved one; the bytes are only meant to be read back by the same build on the same kind of machine.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace sf;
+
+class StateWriter
+{
+private:
+    std::vector<char>& m_Buffer;
+
+public:
+    // Constructor that appends to a buffer.
+    // @param buffer The buffer the state is appended to.
+    explicit StateWriter(std::vector<char>& buffer) : m_Buffer(buffer) {}
+
+    // @brief Append the bytes of a value.
+    // @param value A value that can be copied bit for bit.
+    template <class T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        m_Buffer.insert(m_Buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    // @brief Append the state of a random engine.
+    // @param engine The engine.
+    void writeEngine(const std::mt19937& engine)
+    {
+        std::ostringstream out;
+        out << engine;
+        std::string text = out.str();
+        write(static_cast<unsigned>(text.size()));
+        m_Buffer.insert(m_Buffer.end(), text.begin(), text.end());
+    }
+
+    // @brief Append the position, rotation, scale and origin of a transformable.
+    // @param transformable The sprite or shape.
+    void writeTransform(const Transformable& transformable)
+    {
+        write(transformable.getPosition());
+        write(transformable.getRotation());
+        write(transformable.getScale());
+        write(transformable.getOrigin());
+    }
+};
+
+class StateReader
+{
+private:
+    const char* m_Data;
+    const char* m_End;
+    bool m_Failed = false;
+
+public:
+    // Constructor that reads from a range of bytes.
+    // @param data The first byte.
+    // @param size The number of bytes.
+    StateReader(const char* data, size_t size) : m_Data(data), m_End(data + size) {}
+
+    // @brief Read the bytes of a value.
+    // @param value Set to the value, left unchanged once the data ran out.
+    template <class T>
+    void read(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+        if (m_Failed || static_cast<size_t>(m_End - m_Data) < sizeof(T))
+        {
+            m_Failed = true;
+            return;
+        }
+        std::memcpy(&value, m_Data, sizeof(T));
+        m_Data += sizeof(T);
+    }
+
+    // @brief Read the state of a random engine.
+    // @param engine Set to the saved state.
+    void readEngine(std::mt19937& engine)
+    {
+        unsigned size = 0;
+        read(size);
+        if (m_Failed || static_cast<size_t>(m_End - m_Data) < size)
+        {
+            m_Failed = true;
+            return;
+        }
+
+        std::istringstream in(std::string(m_Data, size));
+        in >> engine;
+        m_Data += size;
+        m_Failed = m_Failed || in.fail();
+    }
+
+    // @brief Read the position, rotation, scale and origin of a transformable.
+    // @param transformable The sprite or shape to set.
+    void readTransform(Transformable& transformable)
+    {
+        Vector2f position, scale, origin;
+        float rotation = 0;
+        read(position);
+        read(rotation);
+        read(scale);
+        read(origin);
+        transformable.setPosition(position);
+        transformable.setRotation(rotation);
+        transformable.setScale(scale);
+        transformable.setOrigin(origin);
+    }
+
+    // @brief Mark the state as malformed, when a value read makes no sense.
+    void fail()
+    {
+        m_Failed = true;
+    }
+
+    // @brief Check whether every read found its data.
+    // @return False if the data ran out or was malformed.
+    bool isValid() const
+    {
+        return !m_Failed;
+    }
+
+    // @brief Check whether every byte was read.
+    bool atEnd() const
+    {
+        return m_Data == m_End;
+    }
+};
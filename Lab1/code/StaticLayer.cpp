@@ -0,0 +1,96 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the StaticLayer class. A dirty cell is redrawn through a view whose viewport covers
+only that cell, so the background and the neighboring mushrooms are clipped to the cell and the pixels
+around it are left untouched. Mushrooms are placed at the top left of their cell, so only the mushrooms of the
+region and of the cells to its left and above it can reach into it, and those are looked up in the grid.
+*/
+
+#include <algorithm>
+
+#include "StaticLayer.h"
+
+// Constructor that creates the off-screen texture.
+// @param background The background sprite, drawn under the mushrooms.
+// @param width The width of the layer in pixels.
+// @param height The height of the layer in pixels.
+StaticLayer::StaticLayer(const Sprite& background, unsigned width, unsigned height)
+    : m_Background(background)
+{
+    m_Columns = (width + MushroomField::CELL_SIZE - 1) / MushroomField::CELL_SIZE;
+    m_Rows = (height + MushroomField::CELL_SIZE - 1) / MushroomField::CELL_SIZE;
+
+    m_Texture.create(width, height);
+    m_Sprite.setTexture(m_Texture.getTexture(), true);
+}
+
+// @brief Draw the background and the mushrooms of a region of the layer.
+// @param snapshot The snapshot holding the mushrooms.
+// @param firstColumn, lastColumn, firstRow, lastRow The inclusive range of grid cells to draw.
+void StaticLayer::drawCells(const RenderSnapshot& snapshot, int firstColumn, int lastColumn, int firstRow, int lastRow)
+{
+    const int cell = MushroomField::CELL_SIZE;
+    FloatRect area(firstColumn * cell, firstRow * cell, (lastColumn - firstColumn + 1) * cell, (lastRow - firstRow + 1) * cell);
+
+    // Restrict drawing to the region
+    Vector2f size(m_Texture.getSize());
+    View view(area);
+    view.setViewport(FloatRect(area.left / size.x, area.top / size.y, area.width / size.x, area.height / size.y));
+    m_Texture.setView(view);
+
+    // Erase the region, then draw it again from the bottom up
+    RectangleShape eraser(Vector2f(area.width, area.height));
+    eraser.setPosition(area.left, area.top);
+    eraser.setFillColor(Color::Black);
+    m_Texture.draw(eraser, RenderStates(BlendNone));
+    m_Texture.draw(m_Background);
+
+    // Mushrooms of the cells to the left and above may overlap the region
+    for (int row = std::max(firstRow - 1, 0); row <= lastRow; row++)
+    {
+        for (int column = std::max(firstColumn - 1, 0); column <= lastColumn; column++)
+        {
+            int index = snapshot.mushroomCells[row * m_Columns + column];
+            if (index != MushroomField::EMPTY && snapshot.mushrooms[index].getGlobalBounds().intersects(area))
+            {
+                m_Texture.draw(snapshot.mushrooms[index]);
+            }
+        }
+    }
+
+    m_Texture.setView(m_Texture.getDefaultView());
+}
+
+// @brief Redraw the cells of the mushroom field that changed since the previous snapshot.
+// @param snapshot The snapshot.
+void StaticLayer::update(const RenderSnapshot& snapshot)
+{
+    if (snapshot.allDirty)
+    {
+        drawCells(snapshot, 0, m_Columns - 1, 0, m_Rows - 1);
+    }
+    else if (snapshot.dirtyCells.empty())
+    {
+        return;
+    }
+    else
+    {
+        for (int cell : snapshot.dirtyCells)
+        {
+            drawCells(snapshot, cell % m_Columns, cell % m_Columns, cell / m_Columns, cell / m_Columns);
+        }
+    }
+
+    m_Texture.display();
+}
+
+// @brief Get the sprite showing the layer.
+// @return The sprite to draw under the moving objects.
+const Sprite& StaticLayer::getSprite() const
+{
+    return m_Sprite;
+}
@@ -0,0 +1,56 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the StaticLayer class, an off-screen image of everything that does not move:
+the background and the mushroom field. The layer is drawn once into a RenderTexture and afterwards only
+the grid cells of the mushrooms that were hit, added or removed are redrawn, so a frame draws the whole
+static scene as a single sprite. The layer is drawn from render snapshots, on the render thread.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+
+#include "RenderSnapshot.h"
+
+using namespace sf;
+
+class StaticLayer
+{
+private:
+    // The composited background and mushrooms
+    RenderTexture m_Texture;
+
+    // The background drawn under the mushrooms
+    Sprite m_Background;
+
+    // The sprite showing m_Texture
+    Sprite m_Sprite;
+
+    // Size of the mushroom grid
+    int m_Columns;
+    int m_Rows;
+
+    // @brief Draw the background and the mushrooms of a region of the layer.
+    // @param snapshot The snapshot holding the mushrooms.
+    // @param firstColumn, lastColumn, firstRow, lastRow The inclusive range of grid cells to draw.
+    void drawCells(const RenderSnapshot& snapshot, int firstColumn, int lastColumn, int firstRow, int lastRow);
+
+public:
+    // Constructor that creates the off-screen texture.
+    // @param background The background sprite, drawn under the mushrooms.
+    // @param width The width of the layer in pixels.
+    // @param height The height of the layer in pixels.
+    StaticLayer(const Sprite& background, unsigned width, unsigned height);
+
+    // @brief Redraw the cells of the mushroom field that changed since the previous snapshot.
+    //        Call it once for every snapshot acquired.
+    // @param snapshot The snapshot.
+    void update(const RenderSnapshot& snapshot);
+
+    // @brief Get the sprite showing the layer.
+    // @return The sprite to draw under the moving objects.
+    const Sprite& getSprite() const;
+};
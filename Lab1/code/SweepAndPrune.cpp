@@ -0,0 +1,236 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the SweepAndPrune broadphase. The sort order of the previous step is kept, so the
+insertion sort only moves the few objects that overtook each other along x.
+*/
+
+#include <algorithm>
+
+#include "SweepAndPrune.h"
+
+// @brief Check whether pairs of two kinds are reported.
+bool SweepAndPrune::wantsPair(Kind a, Kind b) const
+{
+    return m_PairMask & (1u << (a * KIND_COUNT + b));
+}
+
+// @brief Report the pairs made of two kinds of objects.
+// @param a The first kind.
+// @param b The second kind.
+void SweepAndPrune::enablePair(Kind a, Kind b)
+{
+    m_PairMask |= 1u << (a * KIND_COUNT + b);
+    m_PairMask |= 1u << (b * KIND_COUNT + a);
+}
+
+// @brief Make room for the objects of a kind, so adding them does not allocate.
+// @param kind The kind of the objects.
+// @param count The number of keys, from 0 to count - 1.
+void SweepAndPrune::reserve(Kind kind, int count)
+{
+    std::vector<int>& lookup = m_Lookup[kind];
+    if (count > static_cast<int>(lookup.size()))
+    {
+        lookup.resize(count, -1);
+    }
+
+    // Room for the proxies of every object of the kind, on top of the ones reserved so far
+    std::size_t proxies = m_Proxies.capacity() + count;
+    m_Proxies.reserve(proxies);
+    m_Free.reserve(proxies);
+    m_Order.reserve(proxies);
+}
+
+// @brief Start a new step. Objects not updated before endStep() are dropped.
+void SweepAndPrune::beginStep()
+{
+    for (int id : m_Order)
+    {
+        m_Proxies[id].seen = false;
+    }
+}
+
+// @brief Get the proxy id of an object.
+// @return The proxy id, or -1 if the object is not tracked.
+int SweepAndPrune::find(Kind kind, int key) const
+{
+    const std::vector<int>& lookup = m_Lookup[kind];
+    return key < static_cast<int>(lookup.size()) ? lookup[key] : -1;
+}
+
+// @brief Add an object or update its bounds.
+// @param kind The kind of the object.
+// @param key The index of the object among the objects of its kind.
+// @param owner The game object.
+// @param bounds The axis-aligned bounds of the object.
+void SweepAndPrune::update(Kind kind, int key, void* owner, const FloatRect& bounds)
+{
+    int found = find(kind, key);
+    if (found >= 0)
+    {
+        // The key may have been handed to another object since the last step, its old bounds still keep
+        // the order nearly sorted
+        Proxy& proxy = m_Proxies[found];
+        proxy.owner = owner;
+        proxy.bounds = bounds;
+        proxy.alive = true;
+        proxy.seen = true;
+        return;
+    }
+
+    // New object, it is appended and moved to its place by the sort
+    int id;
+    if (m_Free.empty())
+    {
+        id = static_cast<int>(m_Proxies.size());
+        m_Proxies.push_back(Proxy());
+    }
+    else
+    {
+        id = m_Free.back();
+        m_Free.pop_back();
+    }
+
+    m_Proxies[id] = Proxy{ owner, kind, key, bounds, true, true };
+    std::vector<int>& lookup = m_Lookup[kind];
+    if (key >= static_cast<int>(lookup.size()))
+    {
+        lookup.resize(key + 1, -1);
+    }
+    lookup[key] = id;
+    m_Order.push_back(id);
+}
+
+// @brief Check whether a proxy sorts after another one.
+//        Objects lined up on x, such as the lasers fired from the same place, would otherwise keep the order
+//        they were added in, which depends on the addresses the objects were allocated at.
+bool SweepAndPrune::sortsAfter(int a, int b) const
+{
+    const Proxy& first = m_Proxies[a];
+    const Proxy& second = m_Proxies[b];
+    if (first.bounds.left != second.bounds.left)
+    {
+        return first.bounds.left > second.bounds.left;
+    }
+    if (first.bounds.top != second.bounds.top)
+    {
+        return first.bounds.top > second.bounds.top;
+    }
+    return first.kind > second.kind;
+}
+
+// @brief Drop the objects that were not updated, restore the sort order and find the overlapping pairs.
+void SweepAndPrune::endStep()
+{
+    // Drop the objects that no longer exist
+    auto last = std::remove_if(m_Order.begin(), m_Order.end(), [this](int id)
+    {
+        Proxy& proxy = m_Proxies[id];
+        if (proxy.seen)
+        {
+            return false;
+        }
+
+        m_Lookup[proxy.kind][proxy.key] = -1;
+        m_Free.push_back(id);
+        return true;
+    });
+    m_Order.erase(last, m_Order.end());
+
+    // Insertion sort on the left edge, nearly sorted from the previous step
+    for (std::size_t i = 1; i < m_Order.size(); i++)
+    {
+        int id = m_Order[i];
+
+        std::size_t j = i;
+        while (j > 0 && sortsAfter(m_Order[j - 1], id))
+        {
+            m_Order[j] = m_Order[j - 1];
+            j--;
+        }
+        m_Order[j] = id;
+    }
+
+    // Sweep: an object can only overlap the following ones that start before its right edge
+    m_Pairs.clear();
+    for (std::size_t i = 0; i < m_Order.size(); i++)
+    {
+        const Proxy& a = m_Proxies[m_Order[i]];
+        float right = a.bounds.left + a.bounds.width;
+
+        for (std::size_t j = i + 1; j < m_Order.size(); j++)
+        {
+            const Proxy& b = m_Proxies[m_Order[j]];
+            if (b.bounds.left >= right)
+            {
+                break;
+            }
+
+            if (wantsPair(a.kind, b.kind) && a.bounds.intersects(b.bounds))
+            {
+                if (a.kind <= b.kind)
+                {
+                    m_Pairs.push_back(Pair{ m_Order[i], m_Order[j] });
+                }
+                else
+                {
+                    m_Pairs.push_back(Pair{ m_Order[j], m_Order[i] });
+                }
+            }
+        }
+    }
+}
+
+// @brief Mark an object as destroyed. The pairs it belongs to are kept but report it as dead.
+// @param kind The kind of the object.
+// @param key The index of the object among the objects of its kind.
+void SweepAndPrune::remove(Kind kind, int key)
+{
+    int id = find(kind, key);
+    if (id >= 0)
+    {
+        m_Proxies[id].alive = false;
+    }
+}
+
+// @brief Check whether an object was removed during the current step.
+// @param kind The kind of the object.
+// @param key The index of the object among the objects of its kind.
+// @return True if the object is not tracked or was removed.
+bool SweepAndPrune::isRemoved(Kind kind, int key) const
+{
+    int id = find(kind, key);
+    return id < 0 || !m_Proxies[id].alive;
+}
+
+// @brief Get the overlapping pairs found by the last endStep().
+// @return The pairs, in sweep order.
+const std::vector<SweepAndPrune::Pair>& SweepAndPrune::getPairs() const
+{
+    return m_Pairs;
+}
+
+// @brief Get a proxy of a pair.
+// @param id The proxy id.
+// @return The proxy.
+const SweepAndPrune::Proxy& SweepAndPrune::getProxy(int id) const
+{
+    return m_Proxies[id];
+}
+
+// @brief Forget all the objects.
+void SweepAndPrune::clear()
+{
+    m_Proxies.clear();
+    m_Free.clear();
+    m_Order.clear();
+    for (std::vector<int>& lookup : m_Lookup)
+    {
+        lookup.clear();
+    }
+    m_Pairs.clear();
+}
@@ -0,0 +1,129 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the SweepAndPrune class, the collision broadphase for the moving game objects
+(lasers, centipedes, spider and starship). The axis-aligned bounds of the objects are kept sorted
+along x; since objects move little between two steps, the order of the previous step is almost sorted and
+an insertion sort restores it in close to linear time. Sweeping the sorted list reports every overlapping
+pair of object kinds that the game is interested in, which the game then resolves with its usual rules.
+Objects are identified by their kind and a small index the game gives them, such as the slot of a laser in
+its ring, so finding the proxy of an object is a lookup in a flat table and a step allocates nothing once
+the tables have grown to the number of objects.
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+using namespace sf;
+
+class SweepAndPrune
+{
+public:
+    // The kinds of objects tracked by the broadphase
+    enum Kind { Laser, Centipede, Spider, Starship, KIND_COUNT };
+
+    // An object tracked by the broadphase
+    struct Proxy
+    {
+        // The game object
+        void* owner;
+        Kind kind;
+
+        // The index of the object among the objects of its kind
+        int key;
+        FloatRect bounds;
+
+        // False once the object was removed during the current step
+        bool alive;
+
+        // Set when the object is updated during the current step
+        bool seen;
+    };
+
+    // Two overlapping proxies, first has the lower kind
+    struct Pair
+    {
+        int first;
+        int second;
+    };
+
+private:
+    // All proxies, indexed by proxy id, reused through m_Free
+    std::vector<Proxy> m_Proxies;
+    std::vector<int> m_Free;
+
+    // Proxy ids sorted by the left edge of their bounds, then by their top edge and kind
+    std::vector<int> m_Order;
+
+    // Proxy id of each object, indexed by kind then key, -1 for the keys not in use
+    std::vector<int> m_Lookup[KIND_COUNT];
+
+    // Overlapping pairs found by the last sweep
+    std::vector<Pair> m_Pairs;
+
+    // Bit (a * KIND_COUNT + b) is set when pairs of kinds a and b are reported
+    unsigned m_PairMask = 0;
+
+    // @brief Check whether pairs of two kinds are reported.
+    bool wantsPair(Kind a, Kind b) const;
+
+    // @brief Check whether a proxy sorts after another one. Ties on the left edge are broken by the bounds
+    //        and the kind, so the order, and the order of the pairs, only depends on where the objects are.
+    bool sortsAfter(int a, int b) const;
+
+    // @brief Get the proxy id of an object.
+    // @return The proxy id, or -1 if the object is not tracked.
+    int find(Kind kind, int key) const;
+
+public:
+    // @brief Report the pairs made of two kinds of objects.
+    // @param a The first kind.
+    // @param b The second kind.
+    void enablePair(Kind a, Kind b);
+
+    // @brief Make room for the objects of a kind, so adding them does not allocate.
+    // @param kind The kind of the objects.
+    // @param count The number of keys, from 0 to count - 1.
+    void reserve(Kind kind, int count);
+
+    // @brief Start a new step. Objects not updated before endStep() are dropped.
+    void beginStep();
+
+    // @brief Add an object or update its bounds.
+    // @param kind The kind of the object.
+    // @param key The index of the object among the objects of its kind, no other object of the kind
+    //            updated during the step may use it.
+    // @param owner The game object.
+    // @param bounds The axis-aligned bounds of the object.
+    void update(Kind kind, int key, void* owner, const FloatRect& bounds);
+
+    // @brief Drop the objects that were not updated, restore the sort order and find the overlapping pairs.
+    void endStep();
+
+    // @brief Mark an object as destroyed. The pairs it belongs to are kept but report it as dead.
+    // @param kind The kind of the object.
+    // @param key The index of the object among the objects of its kind.
+    void remove(Kind kind, int key);
+
+    // @brief Check whether an object was removed during the current step.
+    // @param kind The kind of the object.
+    // @param key The index of the object among the objects of its kind.
+    // @return True if the object is not tracked or was removed.
+    bool isRemoved(Kind kind, int key) const;
+
+    // @brief Get the overlapping pairs found by the last endStep().
+    // @return The pairs, in sweep order.
+    const std::vector<Pair>& getPairs() const;
+
+    // @brief Get a proxy of a pair.
+    // @param id The proxy id.
+    // @return The proxy.
+    const Proxy& getProxy(int id) const;
+
+    // @brief Forget all the objects.
+    void clear();
+};
@@ -0,0 +1,219 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This file implements the TaskGraph class. Each task keeps a count of the dependencies it still waits for;
+the task that brings a count to zero submits the waiting task, so no thread ever blocks on a dependency.
+*/
+
+#include <chrono>
+#include <stdexcept>
+
+#include "Profiler.h"
+#include "TaskGraph.h"
+
+// @brief Add a task to the graph.
+// @param name The name of the task.
+// @param function The function of the task.
+// @param context Passed to the function.
+// @return The id of the task.
+TaskGraph::TaskId TaskGraph::addTask(const std::string& name, TaskFunction function, void* context)
+{
+    Task task;
+    task.name = name;
+    task.profileName = Profiler::intern(name);
+    task.function = function;
+    task.context = context;
+    m_Tasks.push_back(task);
+    m_OrderValid = false;
+    return static_cast<TaskId>(m_Tasks.size()) - 1;
+}
+
+// @brief Make a task wait for another one.
+// @param before The task that must finish first.
+// @param after The task that waits.
+void TaskGraph::precede(TaskId before, TaskId after)
+{
+    m_Tasks[before].successors.push_back(after);
+    m_Tasks[after].dependencies++;
+    m_OrderValid = false;
+}
+
+// @brief Make a task wait for several others.
+// @param befores The tasks that must finish first.
+// @param after The task that waits.
+void TaskGraph::precede(std::initializer_list<TaskId> befores, TaskId after)
+{
+    for (TaskId before : befores)
+    {
+        precede(before, after);
+    }
+}
+
+// @brief Sort the tasks so every task comes after the tasks it depends on, in declaration order otherwise.
+void TaskGraph::sortTasks()
+{
+    if (m_OrderValid)
+    {
+        return;
+    }
+
+    int count = static_cast<int>(m_Tasks.size());
+    std::vector<int> remaining(count);
+    m_Order.clear();
+    for (int i = 0; i < count; i++)
+    {
+        remaining[i] = m_Tasks[i].dependencies;
+        if (remaining[i] == 0)
+        {
+            m_Order.push_back(i);
+        }
+    }
+
+    for (size_t i = 0; i < m_Order.size(); i++)
+    {
+        for (int successor : m_Tasks[m_Order[i]].successors)
+        {
+            if (--remaining[successor] == 0)
+            {
+                m_Order.push_back(successor);
+            }
+        }
+    }
+
+    if (static_cast<int>(m_Order.size()) != count)
+    {
+        throw std::logic_error("TaskGraph: the dependencies form a cycle");
+    }
+
+    m_Remaining.reset(new std::atomic<int>[count]);
+    m_Durations.reset(new std::int64_t[count]());
+    m_Counters.reset(new PerfCounters::Values[count]);
+    m_OrderValid = true;
+}
+
+// @brief Run every task once on the calling thread, in an order respecting the dependencies.
+void TaskGraph::run()
+{
+    sortTasks();
+    m_Runs++;
+    for (int task : m_Order)
+    {
+        runTimed(task);
+    }
+}
+
+// @brief Run every task once on a job system and wait for all of them.
+// @param jobs The job system.
+void TaskGraph::run(JobSystem& jobs)
+{
+    sortTasks();
+    m_Runs++;
+
+    JobSystem::Counter counter;
+    m_Jobs = &jobs;
+    m_Counter = &counter;
+
+    // Set every count before the first task can decrement one
+    for (size_t i = 0; i < m_Tasks.size(); i++)
+    {
+        m_Remaining[i] = m_Tasks[i].dependencies;
+    }
+
+    for (size_t i = 0; i < m_Tasks.size(); i++)
+    {
+        if (m_Tasks[i].dependencies == 0)
+        {
+            jobs.submit(&TaskGraph::runTask, this, static_cast<int>(i), counter);
+        }
+    }
+
+    jobs.wait(counter);
+    m_Jobs = nullptr;
+    m_Counter = nullptr;
+}
+
+// @brief Job running a task, then submitting the successors it was the last dependency of.
+// @param context The graph.
+// @param index The task.
+void TaskGraph::runTask(void* context, int index)
+{
+    TaskGraph* graph = static_cast<TaskGraph*>(context);
+    const Task& task = graph->m_Tasks[index];
+    graph->runTimed(index);
+
+    // The successors are submitted before this job counts as finished, so the counter cannot reach zero early
+    for (int successor : task.successors)
+    {
+        if (graph->m_Remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            graph->m_Jobs->submit(&TaskGraph::runTask, graph, successor, *graph->m_Counter);
+        }
+    }
+}
+
+// @brief Run a task and measure how long it took.
+// @param index The task.
+void TaskGraph::runTimed(int index)
+{
+    const Task& task = m_Tasks[index];
+    PROFILE_SCOPE(task.profileName);
+
+#ifdef LAB1_PERF_COUNTERS
+    PerfCounters::Values before, after;
+    bool counted = PerfCounters::read(before);
+#endif
+
+    auto start = std::chrono::steady_clock::now();
+    task.function(task.context);
+    m_Durations[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef LAB1_PERF_COUNTERS
+    if (counted && PerfCounters::read(after))
+    {
+        m_Counters[index] = after - before;
+    }
+    else
+    {
+        // The counts of the previous run must not be added again
+        m_Counters[index] = PerfCounters::Values();
+    }
+#endif
+}
+
+// @brief Get the number of tasks.
+int TaskGraph::size() const
+{
+    return static_cast<int>(m_Tasks.size());
+}
+
+// @brief Get the name of a task.
+// @param task The id of the task.
+const std::string& TaskGraph::getName(TaskId task) const
+{
+    return m_Tasks[task].name;
+}
+
+// @brief Get how long a task took in the last run.
+// @param task The id of the task.
+// @return The duration in nanoseconds, 0 before the first run.
+std::int64_t TaskGraph::getDuration(TaskId task) const
+{
+    return m_Durations ? m_Durations[task] : 0;
+}
+
+// @brief Get the number of times the graph ran.
+std::uint64_t TaskGraph::getRuns() const
+{
+    return m_Runs;
+}
+
+// @brief Get the hardware counters of a task in the last run.
+// @param task The id of the task.
+// @return The counts, 0 when the counters are unavailable.
+PerfCounters::Values TaskGraph::getCounters(TaskId task) const
+{
+    return m_Counters ? m_Counters[task] : PerfCounters::Values();
+}
@@ -0,0 +1,123 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the TaskGraph class, a set of named tasks and the dependencies between them.
+The graph is declared once and run as many times as needed. On a JobSystem a task is submitted as soon as
+all the tasks it depends on finished, so tasks that do not depend on each other run concurrently; without
+one the tasks run on the calling thread in a fixed order that respects the dependencies.
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "PerfCounters.h"
+
+class TaskGraph
+{
+public:
+    // The function of a task, called with the context it was added with
+    typedef void (*TaskFunction)(void* context);
+
+private:
+    struct Task
+    {
+        std::string name;
+        const char* profileName;
+        TaskFunction function;
+        void* context;
+
+        // Tasks that may only start once this one finished
+        std::vector<int> successors;
+
+        // Number of tasks this one waits for
+        int dependencies = 0;
+    };
+
+    std::vector<Task> m_Tasks;
+
+    // Tasks in an order where every task comes after the tasks it depends on
+    std::vector<int> m_Order;
+    bool m_OrderValid = false;
+
+    // State of the current run on a job system
+    std::unique_ptr<std::atomic<int>[]> m_Remaining;
+
+    // How long each task took in the last run, written by the thread that ran it
+    std::unique_ptr<std::int64_t[]> m_Durations;
+    std::uint64_t m_Runs = 0;
+
+    // The hardware counters of each task in the last run, only read when built with LAB1_PERF_COUNTERS
+    std::unique_ptr<PerfCounters::Values[]> m_Counters;
+    JobSystem* m_Jobs = nullptr;
+    JobSystem::Counter* m_Counter = nullptr;
+
+    // @brief Sort the tasks so every task comes after the tasks it depends on.
+    //        Throws std::logic_error if the dependencies form a cycle.
+    void sortTasks();
+
+    // @brief Run a task and measure how long it took.
+    // @param index The task.
+    void runTimed(int index);
+
+    // @brief Job running a task, then submitting the successors it was the last dependency of.
+    // @param context The graph.
+    // @param index The task.
+    static void runTask(void* context, int index);
+
+public:
+    // An index of a task in the graph
+    typedef int TaskId;
+
+    // @brief Add a task to the graph.
+    // @param name The name of the task, used in reports.
+    // @param function The function of the task.
+    // @param context Passed to the function.
+    // @return The id of the task.
+    TaskId addTask(const std::string& name, TaskFunction function, void* context);
+
+    // @brief Make a task wait for another one.
+    // @param before The task that must finish first.
+    // @param after The task that waits.
+    void precede(TaskId before, TaskId after);
+
+    // @brief Make a task wait for several others.
+    // @param befores The tasks that must finish first.
+    // @param after The task that waits.
+    void precede(std::initializer_list<TaskId> befores, TaskId after);
+
+    // @brief Run every task once on the calling thread, in an order respecting the dependencies.
+    void run();
+
+    // @brief Run every task once on a job system and wait for all of them.
+    // @param jobs The job system, the calling thread helps running the tasks.
+    void run(JobSystem& jobs);
+
+    // @brief Get the number of tasks.
+    int size() const;
+
+    // @brief Get the name of a task.
+    // @param task The id of the task.
+    const std::string& getName(TaskId task) const;
+
+    // @brief Get how long a task took in the last run.
+    // @param task The id of the task.
+    // @return The duration in nanoseconds, 0 before the first run.
+    std::int64_t getDuration(TaskId task) const;
+
+    // @brief Get the number of times the graph ran.
+    std::uint64_t getRuns() const;
+
+    // @brief Get the hardware counters of a task in the last run.
+    // @param task The id of the task.
+    // @return The counts, 0 when the counters are unavailable.
+    PerfCounters::Values getCounters(TaskId task) const;
+};
@@ -0,0 +1,73 @@
+/*
+Author: Cheng-Jung Hsieh
+Class: ECE6122 A
+Last Date Modified: Mon Sep 23 11:24:03 EDT 2024
+
+Description:
+This header file defines the TripleBuffer class template, which hands values from one producer thread
+to one consumer thread without either of them waiting for the other. The producer fills the back slot
+and publishes it, the consumer reads the newest published slot; the third slot sits in between, so the
+lock is only held to exchange two indices.
+*/
+
+#pragma once
+#include <mutex>
+#include <utility>
+
+template <class T>
+class TripleBuffer
+{
+private:
+    T m_Slots[3];
+
+    // Slot being written by the producer, slot last published, slot being read by the consumer
+    int m_Back = 0;
+    int m_Ready = 1;
+    int m_Front = 2;
+
+    // True when m_Ready was published and not acquired yet
+    bool m_Fresh = false;
+
+    std::mutex m_Mutex;
+
+public:
+    // @brief Get the slot the producer writes to.
+    // @return The back slot, it holds an older value that can be overwritten.
+    T& getBack()
+    {
+        return m_Slots[m_Back];
+    }
+
+    // @brief Publish the back slot to the consumer.
+    // @return True if the value published before was never acquired; it is now the back slot.
+    bool publish()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        bool dropped = m_Fresh;
+        std::swap(m_Back, m_Ready);
+        m_Fresh = true;
+        return dropped;
+    }
+
+    // @brief Make the newest published value the front slot of the consumer.
+    // @return True if a value was published since the previous call.
+    bool acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Fresh)
+        {
+            return false;
+        }
+
+        std::swap(m_Front, m_Ready);
+        m_Fresh = false;
+        return true;
+    }
+
+    // @brief Get the slot the consumer reads from.
+    // @return The value of the last successful acquire(), valid until the next one.
+    const T& getFront() const
+    {
+        return m_Slots[m_Front];
+    }
+};